@@ -0,0 +1,90 @@
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:janggi_master/models/position.dart';
+import 'package:janggi_master/models/rule_mode.dart';
+import 'package:janggi_master/stockfish_ffi.dart';
+import 'package:janggi_master/utils/gib_parser.dart';
+
+// Replays the imported KJA corpus through stockfish_position_state and times
+// how long the engine takes to resolve and play the move tokens of a full
+// game history. Each game is queried alternately with an empty history and
+// with its full history, so every full query replays all moves; the empty
+// queries measure the fixed cost of a call.
+//
+// Usage: probe_token_resolver_benchmark.dart [normalized.jsonl] [rounds]
+
+const String _defaultCorpusPath =
+    'dev/test_tmp/kja_verify/normalized/kja_pds.jsonl';
+
+String _token(Position from, Position to) {
+  String square(Position p) =>
+      '${String.fromCharCode('a'.codeUnitAt(0) + p.file)}${p.rank + 1}';
+  return '${square(from)}${square(to)}';
+}
+
+void main(List<String> args) {
+  final file = File(args.isNotEmpty ? args[0] : _defaultCorpusPath);
+  final rounds = args.length > 1 ? int.parse(args[1]) : 5;
+  if (!file.existsSync()) {
+    print('Corpus not found: ${file.path}');
+    return;
+  }
+
+  final variant = RuleMode.officialKja.engineVariantName;
+  final games = <MapEntry<String, List<String>>>[];
+  for (final line in file.readAsLinesSync()) {
+    if (line.trim().isEmpty) continue;
+    final game = jsonDecode(line) as Map<String, dynamic>;
+    final fen = game['initialFen'] as String?;
+    if (fen == null || fen.trim().isEmpty) continue;
+
+    final tokens = <String>[];
+    for (final raw in List<String>.from(game['moves'] as List<dynamic>)) {
+      final squares = GibParser.parseGibMove(raw);
+      if (squares == null) break;
+      tokens.add(_token(squares['from']!, squares['to']!));
+    }
+    games.add(MapEntry(fen, tokens));
+  }
+
+  StockfishFFI.init();
+  StockfishFFI.isReady();
+
+  // Keep only the prefix of each game that the engine accepts
+  int plies = 0;
+  for (int i = 0; i < games.length; i++) {
+    var tokens = games[i].value;
+    while (tokens.isNotEmpty &&
+        StockfishFFI.getPositionState(
+                rootFen: games[i].key, moves: tokens, variant: variant) ==
+            null) {
+      tokens = tokens.sublist(0, tokens.length ~/ 2);
+    }
+    games[i] = MapEntry(games[i].key, tokens);
+    plies += tokens.length;
+  }
+
+  final empty = Stopwatch();
+  final full = Stopwatch();
+  for (int round = 0; round < rounds; round++) {
+    for (final game in games) {
+      empty.start();
+      StockfishFFI.getPositionState(
+          rootFen: game.key, moves: const <String>[], variant: variant);
+      empty.stop();
+      full.start();
+      StockfishFFI.getPositionState(
+          rootFen: game.key, moves: game.value, variant: variant);
+      full.stop();
+    }
+  }
+
+  final replayUs = full.elapsedMicroseconds - empty.elapsedMicroseconds;
+  print('${games.length} games, $plies plies, $rounds rounds');
+  print('empty history: ${empty.elapsedMicroseconds ~/ (rounds * games.length)} us/call');
+  print('full history:  ${full.elapsedMicroseconds ~/ (rounds * games.length)} us/call');
+  print('replay:        ${(replayUs / (rounds * plies)).toStringAsFixed(2)} us/ply');
+
+  StockfishFFI.cleanup();
+}
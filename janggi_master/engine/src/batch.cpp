@@ -0,0 +1,216 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "apiutil.h"
+#include "batch.h"
+#include "movegen.h"
+#include "search.h"
+#include "thread.h"
+#include "tt.h"
+#include "uci.h"
+#include "variant.h"
+
+namespace Stockfish {
+
+namespace {
+
+  struct Job {
+    size_t id;
+    std::string fen;
+    Depth depth;
+    int64_t nodes;
+  };
+
+  // FENs are read from the input as they are, so quotes and backslashes in
+  // them must be escaped in the JSON output
+  std::string escape_json(const std::string& str) {
+
+    std::string escaped;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+  }
+
+  // Jobs are handed out through an atomic index and results are written
+  // to the output stream under a mutex.
+  struct JobQueue {
+    const Variant* variant;
+    std::vector<Job> jobs;
+    std::atomic<size_t> next;
+    std::ostream* out;
+    std::mutex mutex;
+  };
+
+  // A Worker is a search thread outside of the thread pool. Its search()
+  // analyses jobs from the queue until there are none left.
+  class Worker : public Thread {
+
+  public:
+    Worker(size_t n, JobQueue& q) : Thread(n), queue(q) {}
+    void search() override;
+
+  private:
+    std::string result(const Job& job) const;
+
+    JobQueue& queue;
+  };
+
+  void Worker::search() {
+
+    // The histories of a new thread are not initialized
+    clear();
+
+    for (size_t i = queue.next++; i < queue.jobs.size(); i = queue.next++)
+    {
+        const Job& job = queue.jobs[i];
+        std::string line;
+
+        if (FEN::validate_fen(job.fen, queue.variant) != FEN::FEN_OK)
+            line = "{\"id\":" + std::to_string(job.id) + ",\"error\":\"invalid fen\"}";
+        else
+        {
+            rootPos.set(queue.variant, job.fen, false, &rootState, this);
+            rootMoves.clear();
+            for (const auto& m : MoveList<LEGAL>(rootPos))
+                rootMoves.emplace_back(m);
+
+            if (rootMoves.empty())
+                line = "{\"id\":" + std::to_string(job.id) + ",\"error\":\"no legal moves\"}";
+            else
+            {
+                nodes = tbHits = nmpMinPly = bestMoveChanges = 0;
+                ttProbes = ttHits = 0;
+                evalCacheProbes = evalCacheHits = 0;
+                rootDepth = completedDepth = 0;
+                depthLimit = job.depth;
+                nodesLimit = job.nodes;
+
+                Thread::search();
+
+                line = result(job);
+            }
+        }
+
+        std::lock_guard<std::mutex> lk(queue.mutex);
+        *queue.out << line << std::endl;
+    }
+  }
+
+  std::string Worker::result(const Job& job) const {
+
+    const Search::RootMove& rm = rootMoves[0];
+    std::stringstream ss;
+
+    ss << "{\"id\":" << job.id
+       << ",\"fen\":\"" << escape_json(job.fen)
+       << "\",\"depth\":" << completedDepth
+       << ",\"seldepth\":" << rm.selDepth
+       << ",\"nodes\":" << nodes.load(std::memory_order_relaxed)
+       << ",\"score\":\"" << UCI::value(rm.score)
+       << "\",\"bestmove\":\"" << UCI::move(rootPos, rm.pv[0])
+       << "\",\"pv\":[";
+
+    for (size_t i = 0; i < rm.pv.size(); ++i)
+        ss << (i ? ",\"" : "\"") << UCI::move(rootPos, rm.pv[i]) << "\"";
+
+    ss << "]}";
+    return ss.str();
+  }
+
+  // Reads one job per line, see Batch::run()
+  void read_jobs(std::istream& in, Depth depth, int64_t nodes, std::vector<Job>& jobs) {
+
+    std::string line, token;
+
+    while (std::getline(in, line))
+    {
+        std::istringstream is(line);
+        Job job{jobs.size(), "", depth, nodes};
+
+        while (is >> token)
+        {
+            if (token == "depth")
+                is >> job.depth;
+            else if (token == "nodes")
+                is >> job.nodes;
+            else
+                job.fen += (job.fen.empty() ? "" : " ") + token;
+        }
+
+        // A job without limits would never finish
+        if (job.depth <= 0 && job.nodes <= 0)
+            job.depth = 1;
+
+        if (!job.fen.empty() && job.fen[0] != '#')
+            jobs.push_back(job);
+    }
+  }
+
+} // namespace
+
+
+namespace Batch {
+
+size_t run(const Variant* v, std::istream& in, std::ostream& out,
+           size_t workers, Depth depth, int64_t nodes) {
+
+  JobQueue queue;
+  queue.variant = v;
+  queue.next = 0;
+  queue.out = &out;
+  read_jobs(in, depth, nodes, queue.jobs);
+
+  // The workers share the global search state with the thread pool, so
+  // make sure the pool is idle and the limits of its last search do not
+  // apply to the jobs.
+  Threads.main()->wait_for_search_finished();
+  Threads.stop = false;
+  Threads.increaseDepth = true;
+  Search::Limits = Search::LimitsType();
+  Search::Limits.multiPV = 1;
+  TT.new_search();
+
+  std::vector<std::unique_ptr<Worker>> pool;
+  workers = std::max(std::min(workers, queue.jobs.size()), size_t(1));
+  for (size_t i = 0; i < workers; ++i)
+      pool.emplace_back(new Worker(i + 1, queue));
+
+  for (auto& w : pool)
+      w->start_searching();
+
+  for (auto& w : pool)
+      w->wait_for_search_finished();
+
+  return queue.jobs.size();
+}
+
+} // namespace Batch
+
+} // namespace Stockfish
@@ -0,0 +1,47 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+#include <iosfwd>
+
+#include "types.h"
+
+namespace Stockfish {
+
+struct Variant;
+
+namespace Batch {
+
+/// Batch::run() analyses a list of positions on independent search workers.
+/// Each line of 'in' holds a FEN, optionally followed by "depth N" and/or
+/// "nodes N" overriding the default limits; empty lines and lines starting
+/// with '#' are skipped. The jobs are shared out over 'workers' threads that
+/// each have their own position and histories and share the TT. One JSON line
+/// per job is written to 'out' as soon as the job completes, so the output
+/// order is not the input order. Returns the number of jobs.
+
+size_t run(const Variant* v, std::istream& in, std::ostream& out,
+           size_t workers, Depth depth, int64_t nodes);
+
+} // namespace Batch
+
+} // namespace Stockfish
+
+#endif // #ifndef BATCH_H_INCLUDED
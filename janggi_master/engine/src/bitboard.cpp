@@ -24,6 +24,10 @@
 #include "misc.h"
 #include "piece.h"
 
+#if defined(JANGGI_ONLY) && defined(PRECOMPUTED_MAGICS)
+#error "Precomputed magics are only available for the 12x10 board"
+#endif
+
 // Helper macro for logging
 #ifdef __ANDROID__
 #include <android/log.h>
@@ -48,6 +52,7 @@ Bitboard LeaperMoves[2][COLOR_NB][PIECE_TYPE_NB][SQUARE_NB];
 Bitboard BoardSizeBB[FILE_NB][RANK_NB];
 RiderType AttackRiderTypes[PIECE_TYPE_NB];
 RiderType MoveRiderTypes[2][PIECE_TYPE_NB];
+PieceSet SymmetricMoveTypes;
 
 Magic RookMagicsH[SQUARE_NB];
 Magic RookMagicsV[SQUARE_NB];
@@ -74,7 +79,16 @@ namespace {
 
 // Some magics need to be split in order to reduce memory consumption.
 // Otherwise on a 12x10 board they can be >100 MB.
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+// Tables sized for the 9x10 board. Riders that no Janggi piece uses get no
+// table, their magics are never initialized.
+Bitboard RookTableH[0x1B80];           // To store horizontal rook attacks
+Bitboard RookTableV[0x3600];           // To store vertical rook attacks
+Bitboard CannonTableH[0x1B80];         // To store horizontal cannon attacks
+Bitboard CannonTableV[0x3600];         // To store vertical cannon attacks
+Bitboard HorseTable[0x380];            // To store horse attacks
+Bitboard JanggiElephantTable[0xEE00];  // To store janggi elephant attacks
+#elif defined(LARGEBOARDS)
 Bitboard RookTableH[0x11800];          // To store horizontal rook attacks
 Bitboard RookTableV[0x4800];           // To store vertical rook attacks
 Bitboard BishopTable[0x33C00];         // To store bishop attacks
@@ -255,6 +269,12 @@ std::string Bitboards::pretty(Bitboard b) {
 void Bitboards::init_pieces() {
 
   for (PieceType pt = PAWN; pt <= KING; ++pt) {
+#ifdef JANGGI_ONLY
+    // Attack tables of other pieces stay empty, except for the fers, pawn
+    // and bishop tables that palace diagonal moves are built from
+    if (!((JANGGI_PIECES | FERS | PAWN | BISHOP) & pt))
+      continue;
+#endif
     const PieceInfo *pi = pieceMap.find(pt)->second;
 
     // Detect rider types
@@ -300,6 +320,15 @@ void Bitboards::init_pieces() {
       }
     }
 
+    // Pieces that move the way they capture, so that their quiet moves are
+    // the empty squares they attack, outside of double step regions
+    if (pi->steps[0][MODALITY_QUIET] == pi->steps[0][MODALITY_CAPTURE] &&
+        pi->slider[0][MODALITY_QUIET] == pi->slider[0][MODALITY_CAPTURE] &&
+        pi->hopper[0][MODALITY_QUIET] == pi->hopper[0][MODALITY_CAPTURE])
+      SymmetricMoveTypes |= pt;
+    else
+      SymmetricMoveTypes &= ~piece_set(pt);
+
     // Initialize move/attack bitboards
     for (Color c : {WHITE, BLACK}) {
       for (Square s = SQ_A1; s <= SQ_MAX; ++s) {
@@ -40,19 +40,27 @@ std::string pretty(Bitboard b);
 
 } // namespace Bitboards
 
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+constexpr Bitboard AllSquares = ((~Bitboard(0)) >> 38);
+#elif defined(LARGEBOARDS)
 constexpr Bitboard AllSquares = ((~Bitboard(0)) >> 8);
 #else
 constexpr Bitboard AllSquares = ~Bitboard(0);
 #endif
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+constexpr Bitboard DarkSquares =
+    (Bitboard(0x1555555ULL) << 64) ^ Bitboard(0x5555555555555555ULL);
+#elif defined(LARGEBOARDS)
 constexpr Bitboard DarkSquares =
     (Bitboard(0xAAA555AAA555AAULL) << 64) ^ Bitboard(0xA555AAA555AAA555ULL);
 #else
 constexpr Bitboard DarkSquares = 0xAA55AA55AA55AA55ULL;
 #endif
 
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+constexpr Bitboard FileABB =
+    (Bitboard(0x20100ULL) << 64) ^ Bitboard(0x8040201008040201ULL);
+#elif defined(LARGEBOARDS)
 constexpr Bitboard FileABB =
     (Bitboard(0x00100100100100ULL) << 64) ^ Bitboard(0x1001001001001001ULL);
 #else
@@ -67,12 +75,16 @@ constexpr Bitboard FileGBB = FileABB << 6;
 constexpr Bitboard FileHBB = FileABB << 7;
 #ifdef LARGEBOARDS
 constexpr Bitboard FileIBB = FileABB << 8;
+#ifndef JANGGI_ONLY
 constexpr Bitboard FileJBB = FileABB << 9;
 constexpr Bitboard FileKBB = FileABB << 10;
 constexpr Bitboard FileLBB = FileABB << 11;
 #endif
+#endif
 
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+constexpr Bitboard Rank1BB = 0x1FF;
+#elif defined(LARGEBOARDS)
 constexpr Bitboard Rank1BB = 0xFFF;
 #else
 constexpr Bitboard Rank1BB = 0xFF;
@@ -112,6 +124,7 @@ extern Bitboard SquareBB[SQUARE_NB];
 extern Bitboard BoardSizeBB[FILE_NB][RANK_NB];
 extern RiderType AttackRiderTypes[PIECE_TYPE_NB];
 extern RiderType MoveRiderTypes[2][PIECE_TYPE_NB];
+extern PieceSet SymmetricMoveTypes;
 
 #ifdef LARGEBOARDS
 int popcount(Bitboard b); // required for 128 bit pext
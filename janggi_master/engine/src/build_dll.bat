@@ -16,7 +16,7 @@ search.cpp thread.cpp timeman.cpp tt.cpp uci.cpp ucioption.cpp tune.cpp ^
 partner.cpp parser.cpp piece.cpp variant.cpp xboard.cpp ^
 syzygy/tbprobe.cpp ^
 nnue/evaluate_nnue.cpp nnue/features/half_ka_v2.cpp nnue/features/half_ka_v2_variants.cpp ^
-c_api.cpp
+batch.cpp gensfen.cpp mate.cpp resultcache.cpp c_api.cpp
 
 REM Build the DLL
 echo Compiling...
@@ -1,4 +1,5 @@
 
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -6,7 +7,10 @@
 #include <algorithm>
 #include <cstring>
 #include <cctype>
+#include <atomic>
+#include <chrono>
 #include <mutex>
+#include <shared_mutex>
 
 #ifdef __ANDROID__
 #include <android/log.h>
@@ -24,17 +28,28 @@
 #include "misc.h"
 #include "movegen.h"
 #include "search.h"
+#include "tt.h"
 #include "variant.h"
 #include "piece.h"
 #include "psqt.h"
 #include "bitboard.h"
 #include "endgame.h"
+#include "batch.h"
+#include "mate.h"
+#include "resultcache.h"
+#include "c_api.h"
 
 using namespace Stockfish;
 
 // Thread safety
 static std::mutex g_engine_mutex;
-static bool g_initialized = false;
+// Searches share the global thread pool and TT, so only one runs at a time
+static std::mutex g_search_mutex;
+// Held shared by session queries whose position is bound to Threads.main()
+// and by session searches, which share the TT, the options and the PSQT with
+// the pool, and exclusively while the thread pool is resized or those change
+static std::shared_mutex g_pool_mutex;
+static std::atomic<bool> g_initialized{false};
 static bool g_threads_initialized_command = false;
 static bool g_threads_initialized_analyze = false;
 static bool g_threads_initialized_state = false;
@@ -67,6 +82,37 @@ StateListPtr g_states(new std::deque<StateInfo>(1));
 // A buffer for the returned output string
 char output_buffer[8192];
 
+template<size_t N>
+static const char* write_output(char (&buffer)[N], const std::string& output) {
+    std::strncpy(buffer, output.c_str(), N - 1);
+    buffer[N - 1] = '\0';
+    return buffer;
+}
+
+// Creates the thread pool on first use. The pool then lives until the
+// library is unloaded, across stockfish_cleanup() and stockfish_init(), and
+// only the Threads option resizes it. Callers must hold g_search_mutex.
+static void ensure_thread_pool() {
+    if (Threads.size() == 0) {
+        std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
+        Threads.set(std::max(size_t(Options["Threads"]), size_t(1)));
+    }
+}
+
+// Sets the Threads option, which adds or removes helper threads of the pool.
+// Callers must hold g_search_mutex.
+static void set_threads_option(const std::string& value) {
+    std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
+    Options["Threads"] = value;
+}
+
+// Clears the TT and the histories of the thread pool, once no session search
+// uses the TT. Callers must hold g_search_mutex.
+static void reset_search() {
+    std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
+    Search::reset();
+}
+
 static std::string normalized_variant_name(const char* variant) {
     if (variant == nullptr || variant[0] == '\0') {
         std::string optionVariant = Options["UCI_Variant"];
@@ -100,8 +146,11 @@ static bool ensure_threads_initialized(
 
     try {
         LOGD("[%s] Initializing threads...", label);
-        Threads.set(1);
-        Search::clear();
+        {
+            std::lock_guard<std::mutex> searchLock(g_search_mutex);
+            ensure_thread_pool();
+            reset_search();
+        }
         std::string error;
         const Variant* variant = find_variant_by_name(variantName, error);
         if (variant == nullptr) {
@@ -164,6 +213,125 @@ static bool build_position_from_history(
     return true;
 }
 
+// A position with a reusable StateInfo history. The StateInfos are kept
+// between calls, so a move list that shares a prefix with the one of the
+// previous call only undoes and plays the moves after the prefix, and any
+// other move list is replayed into the memory of earlier calls instead of a
+// newly allocated list. The legal moves of the last queried position are
+// cached by key, so repeating a query or undoing and replaying a move does
+// not generate them again.
+struct PositionHistory {
+    Position pos;
+    std::string variantName;
+    std::string rootFen;
+    std::vector<std::string> tokens; // Moves played from the root position
+    std::vector<Move> moves;
+    std::deque<StateInfo> states{1};  // Never shrinks, states[i] follows moves[i - 1]
+    bool valid = false;
+    Key legalKey = 0;
+    bool legalValid = false;
+    std::vector<std::string> legalMoves;
+};
+
+// The history of stockfish_position_state, guarded by g_engine_mutex
+static PositionHistory g_state_history;
+
+// Reads the next space-separated token of 'moves' into 'token', reusing its
+// capacity. Returns false at the end of the list.
+static bool next_move_token(const char*& moves, std::string& token) {
+    while (*moves == ' ') {
+        ++moves;
+    }
+    if (*moves == '\0') {
+        return false;
+    }
+
+    const char* end = moves;
+    while (*end != '\0' && *end != ' ') {
+        ++end;
+    }
+    token.assign(moves, end);
+    moves = end;
+    return true;
+}
+
+// Same as build_position_from_history, on the position of 'history'.
+static bool replay_history(
+    PositionHistory& history,
+    const std::string& variantName,
+    const char* rootFen,
+    const char* moves,
+    std::string& error) {
+    const Variant* variant = find_variant_by_name(variantName, error);
+    if (variant == nullptr) {
+        return false;
+    }
+
+    if (rootFen == nullptr) {
+        error = "error: Null root FEN";
+        return false;
+    }
+
+    if (moves == nullptr) {
+        moves = "";
+    }
+
+    // Keep the moves shared with the previous history. The thread pool may
+    // have been recreated since, so the position also has to be bound to the
+    // current main thread.
+    const char* next = moves;
+    std::string token;
+    const bool sameRoot = history.valid
+        && history.pos.this_thread() == Threads.main()
+        && history.variantName == variantName
+        && history.rootFen == rootFen;
+
+    size_t shared = 0;
+    if (sameRoot) {
+        for (const char* p = next;
+             shared < history.tokens.size() && next_move_token(p, token) && token == history.tokens[shared];
+             next = p) {
+            ++shared;
+        }
+    }
+
+    history.valid = false;
+
+    if (!sameRoot) {
+        history.tokens.clear();
+        history.moves.clear();
+        history.legalValid = false;
+        history.variantName = variantName;
+        history.rootFen = rootFen;
+        history.pos.set(variant, history.rootFen, false, &history.states[0], Threads.main());
+    }
+
+    while (history.moves.size() > shared) {
+        history.pos.undo_move(history.moves.back());
+        history.moves.pop_back();
+        history.tokens.pop_back();
+    }
+
+    while (next_move_token(next, token)) {
+        Move move = resolve_move_token(history.pos, token);
+        if (move == MOVE_NONE) {
+            error = "error: Invalid move in history - " + token;
+            history.valid = true;
+            return false;
+        }
+
+        if (history.moves.size() + 1 == history.states.size()) {
+            history.states.emplace_back();
+        }
+        history.pos.do_move(move, history.states[history.moves.size() + 1]);
+        history.moves.push_back(move);
+        history.tokens.push_back(token);
+    }
+
+    history.valid = true;
+    return true;
+}
+
 static std::string escape_json(const std::string& value) {
     std::string escaped;
     escaped.reserve(value.size() + 8);
@@ -251,7 +419,42 @@ static std::string move_to_app_token(const Position& pos, Move move) {
     return from + to;
 }
 
+// Parses a square such as "e10" at 'cursor', case-insensitively, and moves
+// the cursor past it. Returns SQ_NONE if there is no square of the board.
+static Square parse_app_square(const Position& pos, const char*& cursor) {
+    const int file = std::tolower(static_cast<unsigned char>(cursor[0])) - 'a';
+    if (file < 0 || file > pos.max_file() || !std::isdigit(static_cast<unsigned char>(cursor[1]))) {
+        return SQ_NONE;
+    }
+
+    int rank = cursor[1] - '0';
+    cursor += 2;
+    if (std::isdigit(static_cast<unsigned char>(*cursor))) {
+        rank = rank * 10 + (*cursor++ - '0');
+    }
+
+    if (rank < 1 || rank > pos.max_rank() + 1) {
+        return SQ_NONE;
+    }
+    return make_square(File(file), Rank(rank - 1));
+}
+
 static Move resolve_move_token(Position& pos, const std::string& token) {
+    // A plain from-to token is matched on its squares, which is all that
+    // move_to_app_token prints, using a single move generation and no string
+    // formatting. Other tokens, like drops or castling in the king-to
+    // notation, are compared with the UCI and app notation of each move.
+    const char* cursor = token.c_str();
+    const Square from = parse_app_square(pos, cursor);
+    const Square to = from != SQ_NONE ? parse_app_square(pos, cursor) : SQ_NONE;
+    if (to != SQ_NONE && *cursor == '\0') {
+        for (const auto& legalMove : MoveList<LEGAL>(pos)) {
+            if (from_sq(legalMove) == from && to_sq(legalMove) == to) {
+                return legalMove;
+            }
+        }
+    }
+
     std::string moveToken = token;
     Move move = UCI::to_move(pos, moveToken);
     if (move != MOVE_NONE) {
@@ -278,6 +481,465 @@ static bool is_pass_uci_move(const std::string& move) {
     return split_uci_move(move, from, to) && from == to;
 }
 
+// Variant of the previous search. TT and histories are kept warm across
+// searches and only cleared on ucinewgame or when the variant changes.
+static const Variant* g_search_variant = nullptr;
+
+// Clears the search state if the next search is on a different variant.
+// Callers must hold g_search_mutex.
+static void prepare_search(const Variant* variant) {
+    if (variant != g_search_variant) {
+        reset_search();
+        g_search_variant = variant;
+    }
+}
+
+// Returns the number of moves to mate for a mate score, negative when
+// getting mated, or 0 for other scores
+static int mate_in(Value v) {
+    if (v >= VALUE_MATE_IN_MAX_PLY) {
+        return (VALUE_MATE - v + 1) / 2;
+    }
+    if (v <= VALUE_MATED_IN_MAX_PLY) {
+        return (-VALUE_MATE - v) / 2;
+    }
+    return 0;
+}
+
+static void stop_async_search();
+
+// Starts a search on the thread pool and waits for it to finish, with the
+// engine's info output suppressed. A search started by stockfish_search_start
+// is stopped first. Callers must hold g_search_mutex. Ownership of 'states'
+// is transferred to the thread pool.
+static void search_and_wait(Position& pos, StateListPtr& states, const Search::LimitsType& limits) {
+    // Suppress verbose search info output during API analysis calls.
+    ScopedCoutRedirect silence_stdout(&g_null_buffer);
+
+    stop_async_search();
+    Threads.start_thinking(pos, states, limits, false);
+    Threads.main()->wait_for_search_finished();
+}
+
+// Nodes and TT hit rate of the search of 'thread', summed over the thread
+// pool unless the thread searches on its own
+static uint64_t nodes_searched(const Thread* thread) {
+    return thread->ownLimits ? thread->nodes.load(std::memory_order_relaxed) : Threads.nodes_searched();
+}
+
+static uint32_t tt_hit_permille(const Thread* thread) {
+    const uint64_t probes = thread->ownLimits ? thread->ttProbes.load(std::memory_order_relaxed) : Threads.tt_probes();
+    const uint64_t hits = thread->ownLimits ? thread->ttHits.load(std::memory_order_relaxed) : Threads.tt_hits();
+    return probes ? uint32_t(hits * 1000 / probes) : 0;
+}
+
+// Searches limited by depth, and optionally movetime, only depend on the
+// position, so their results are served from and stored in the result cache.
+// MultiPV and strength limited searches are not cached.
+static bool cacheable(const Search::LimitsType& limits) {
+    return   limits.depth > 0
+          && !limits.nodes && !limits.mate && !limits.infinite && !limits.perft
+          && !limits.use_time_management()
+          && limits.searchmoves.empty() && limits.banmoves.empty()
+          && (limits.multiPV ? limits.multiPV : int(Options["MultiPV"])) == 1
+          && !Options["UCI_LimitStrength"]
+          && int(Options["Skill Level"]) >= 20;
+}
+
+// Stores the result of the search of 'thread' from 'pos' in the result cache
+// if its limits allow it
+static void store_result(const Position& pos, const Thread* thread, const Search::LimitsType& limits) {
+    if (!cacheable(limits) || thread->rootMoves.empty()) {
+        return;
+    }
+
+    const Search::RootMove& best = thread->rootMoves[0];
+    ResultCache::store(pos, ResultCache::Entry{best.score, thread->completedDepth, best.selDepth, best.pv});
+}
+
+// Formats an analysis result as "cp 300 bestmove e9f9 tthit 412" or
+// "mate 5 bestmove a1a2 tthit 87"
+static std::string format_analysis(const Position& pos, Value score, Move bestMove, uint32_t ttHitPermille) {
+    std::stringstream ss;
+
+    // Mate scores are reported as "mate N", negative when we are losing
+    if (int mate = mate_in(score)) {
+        ss << "mate " << mate;
+    } else {
+        // Centipawn score
+        ss << "cp " << static_cast<int>(score);
+    }
+
+    // Add best move
+    if (bestMove != MOVE_NONE) {
+        ss << " bestmove " << move_to_app_token(pos, bestMove);
+    }
+
+    ss << " tthit " << ttHitPermille;
+
+    return ss.str();
+}
+
+// Runs a fixed-depth search on the thread pool and formats the result as
+// "cp 300 bestmove e9f9 tthit 412" or "mate 5 bestmove a1a2 tthit 87", where
+// tthit is the TT hit rate of the search in permille. Callers must hold
+// g_search_mutex. Ownership of 'states' is transferred to the thread pool.
+static std::string run_analysis(Position& pos, StateListPtr& states, int depth) {
+    // Set up search limits
+    Search::LimitsType limits;
+    limits.startTime = now();
+    limits.depth = depth;
+
+    // A cached result counts as a full TT hit
+    ResultCache::Entry cached;
+    if (cacheable(limits) && ResultCache::probe(pos, Depth(depth), cached)) {
+        return format_analysis(pos, cached.score, cached.pv[0], 1000);
+    }
+
+    search_and_wait(pos, states, limits);
+
+    // Extract score from rootMoves
+    Thread* mainThread = Threads.main();
+    if (mainThread == nullptr || mainThread->rootMoves.empty()) {
+        LOGE("[ANALYZE] No root moves");
+        return "error: No root moves";
+    }
+
+    store_result(pos, mainThread, limits);
+    return format_analysis(pos, mainThread->rootMoves[0].score, mainThread->rootMoves[0].pv[0], tt_hit_permille(mainThread));
+}
+
+static void copy_token(char (&token)[STOCKFISH_TOKEN_SIZE], const std::string& value) {
+    std::memset(token, 0, sizeof(token));
+    std::strncpy(token, value.c_str(), sizeof(token) - 1);
+}
+
+// Fills 'out' from the root moves of 'thread'. Callers must hold
+// g_search_mutex or be the main search thread.
+static int fill_analysis(const Thread* thread, const Search::LimitsType& limits, StockfishAnalysis* out) {
+    const Position& pos = thread->rootPos;
+    const Search::RootMoves& rootMoves = thread->rootMoves;
+    if (rootMoves.empty()) {
+        return STOCKFISH_ERROR_NO_MOVES;
+    }
+
+    const TimePoint elapsed = now() - limits.startTime + 1;
+    const Search::RootMove& best = rootMoves[0];
+
+    out->score = best.score;
+    out->mate = mate_in(best.score);
+    out->depth = thread->completedDepth;
+    out->selDepth = best.selDepth;
+    out->nodes = nodes_searched(thread);
+    out->nps = out->nodes * 1000 / elapsed;
+    out->timeMs = uint32_t(elapsed);
+    out->ttHitPermille = tt_hit_permille(thread);
+    out->bestmove = best.pv[0];
+    out->ponder = best.pv.size() > 1 ? best.pv[1] : MOVE_NONE;
+    copy_token(out->bestmoveToken, best.pv[0] != MOVE_NONE ? move_to_app_token(pos, best.pv[0]) : "");
+    copy_token(out->ponderToken, out->ponder != MOVE_NONE ? move_to_app_token(pos, Move(out->ponder)) : "");
+
+    // Lines that were not searched at the last depth keep their previous score
+    const size_t multiPV = limits.multiPV ? size_t(limits.multiPV) : size_t(Options["MultiPV"]);
+    const size_t lines = std::min({ multiPV, rootMoves.size(), size_t(STOCKFISH_MAX_PV_LINES) });
+    out->pvCount = int32_t(lines);
+    for (size_t i = 0; i < lines; ++i) {
+        const Search::RootMove& rm = rootMoves[i];
+        const bool updated = rm.score != -VALUE_INFINITE;
+        const Value v = updated ? rm.score : rm.previousScore;
+        StockfishPvLine& line = out->pv[i];
+
+        line.score = v;
+        line.mate = mate_in(v);
+        line.depth = updated ? out->depth : std::max(out->depth - 1, 1);
+        line.selDepth = rm.selDepth;
+        line.length = int32_t(std::min(rm.pv.size(), size_t(STOCKFISH_MAX_PV_MOVES)));
+        for (int j = 0; j < line.length; ++j) {
+            line.moves[j] = rm.pv[j];
+            copy_token(line.tokens[j], move_to_app_token(pos, rm.pv[j]));
+        }
+    }
+
+    return STOCKFISH_OK;
+}
+
+// Fills 'out' from a cached result for 'pos', as if it were a search that
+// took no time and hit the TT on every probe
+static void fill_cached_analysis(const Position& pos, const ResultCache::Entry& entry, StockfishAnalysis* out) {
+    out->score = entry.score;
+    out->mate = mate_in(entry.score);
+    out->depth = entry.depth;
+    out->selDepth = entry.selDepth;
+    out->nodes = 0;
+    out->nps = 0;
+    out->timeMs = 0;
+    out->ttHitPermille = 1000;
+    out->bestmove = entry.pv[0];
+    out->ponder = entry.pv.size() > 1 ? entry.pv[1] : MOVE_NONE;
+    copy_token(out->bestmoveToken, move_to_app_token(pos, entry.pv[0]));
+    copy_token(out->ponderToken, out->ponder != MOVE_NONE ? move_to_app_token(pos, Move(out->ponder)) : "");
+
+    StockfishPvLine& line = out->pv[0];
+    out->pvCount = 1;
+    line.score = out->score;
+    line.mate = out->mate;
+    line.depth = out->depth;
+    line.selDepth = out->selDepth;
+    line.length = int32_t(std::min(entry.pv.size(), size_t(STOCKFISH_MAX_PV_MOVES)));
+    for (int j = 0; j < line.length; ++j) {
+        line.moves[j] = entry.pv[j];
+        copy_token(line.tokens[j], move_to_app_token(pos, entry.pv[j]));
+    }
+}
+
+// Sets up 'fen' in 'pos' and searches it to the given depth, filling 'out'.
+// A non-zero 'multiPV' overrides the MultiPV option. Callers must hold
+// g_search_mutex.
+static int analyze_to_result(
+    const Variant* variant,
+    Position& pos,
+    StateListPtr& states,
+    const char* fen,
+    int depth,
+    int multiPV,
+    StockfishAnalysis* out) {
+    ensure_thread_pool();
+
+    // Keep TT and histories from the previous analysis of the same variant
+    prepare_search(variant);
+
+    states = StateListPtr(new std::deque<StateInfo>(1));
+    pos.set(variant, fen, false, &states->back(), Threads.main());
+
+    Search::LimitsType limits;
+    limits.startTime = now();
+    limits.depth = depth;
+    limits.multiPV = multiPV;
+
+    ResultCache::Entry cached;
+    if (cacheable(limits) && ResultCache::probe(pos, Depth(depth), cached)) {
+        fill_cached_analysis(pos, cached, out);
+        return STOCKFISH_OK;
+    }
+
+    search_and_wait(pos, states, limits);
+    store_result(pos, Threads.main(), limits);
+    return fill_analysis(Threads.main(), limits, out);
+}
+
+// Implements stockfish_analyze_result and stockfish_analyze_multipv
+static int analyze_fen_to_result(const char* variant, const char* fen, int depth, int multiPV, StockfishAnalysis* out) {
+    if (!g_initialized) {
+        return STOCKFISH_ERROR_NOT_INITIALIZED;
+    }
+    if (fen == nullptr || out == nullptr) {
+        return STOCKFISH_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::memset(out, 0, sizeof(StockfishAnalysis));
+    std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+    try {
+        std::string error;
+        const Variant* resolvedVariant = find_variant_by_name(normalized_variant_name(variant), error);
+        if (resolvedVariant == nullptr) {
+            LOGE("[ANALYZE] %s", error.c_str());
+            return STOCKFISH_ERROR_UNKNOWN_VARIANT;
+        }
+
+        Position pos;
+        StateListPtr states;
+        return analyze_to_result(resolvedVariant, pos, states, fen, depth, multiPV, out);
+    } catch (const std::exception& e) {
+        LOGE("[ANALYZE] Exception: %s", e.what());
+        return STOCKFISH_ERROR_EXCEPTION;
+    } catch (...) {
+        LOGE("[ANALYZE] Unknown exception");
+        return STOCKFISH_ERROR_EXCEPTION;
+    }
+}
+
+// The search started by stockfish_search_start. It runs on the thread pool
+// after the call has returned and publishes its progress here from the main
+// search thread. Only one such search runs at a time; other searches wait
+// for it on g_search_mutex and Threads.start_thinking.
+struct AsyncSearch {
+    std::mutex mutex; // Guards the fields below
+    bool active = false;
+    bool finished = false;
+    StockfishAnalysis progress;
+    StockfishProgressCallback callback = nullptr;
+    void* userData = nullptr;
+};
+
+static AsyncSearch g_async;
+
+// Publishes the progress of the search started by stockfish_search_start.
+// Called on the main search thread.
+static void publish_progress(const Thread& thread, bool finished) {
+    StockfishAnalysis info;
+    std::memset(&info, 0, sizeof(info));
+    fill_analysis(&thread, Search::Limits, &info);
+
+    StockfishProgressCallback callback;
+    void* userData;
+    {
+        std::lock_guard<std::mutex> lock(g_async.mutex);
+        g_async.progress = info;
+        g_async.finished = finished;
+        callback = g_async.callback;
+        userData = g_async.userData;
+    }
+
+    if (callback != nullptr) {
+        callback(&info, finished ? 1 : 0, userData);
+    }
+}
+
+// The predicted reply a search started by stockfish_ponder_start ponders on,
+// in both notations accepted by stockfish_ponder_hit. Guarded by
+// g_search_mutex.
+struct PonderState {
+    bool active = false;
+    std::string appToken, uciToken;
+};
+
+static PonderState g_ponder;
+
+// Publishes the search about to be started to stockfish_search_poll and
+// 'callback', and sets the hooks that report its progress.
+static void begin_async_search(Search::LimitsType& limits, StockfishProgressCallback callback, void* userData) {
+    limits.onIteration = [](const Thread& th) { publish_progress(th, false); };
+    limits.onFinished = [](const Thread& th) { publish_progress(th, true); };
+
+    std::lock_guard<std::mutex> lock(g_async.mutex);
+    std::memset(&g_async.progress, 0, sizeof(g_async.progress));
+    g_async.active = true;
+    g_async.finished = false;
+    g_async.callback = callback;
+    g_async.userData = userData;
+}
+
+// Stops the search started by stockfish_search_start, if it is still
+// running, and waits for it. Callers must hold g_search_mutex, so that no
+// other search can be running.
+static void stop_async_search() {
+    bool running;
+    {
+        std::lock_guard<std::mutex> lock(g_async.mutex);
+        running = g_async.active && !g_async.finished;
+    }
+
+    g_ponder.active = false;
+
+    if (running && Threads.size() > 0) {
+        Threads.stop = true;
+        Threads.main()->wait_for_search_finished();
+    }
+}
+
+// Returns the legal moves of the position of 'history' as app tokens,
+// generating them only if the position changed since the last call.
+static const std::vector<std::string>& legal_move_tokens(PositionHistory& history) {
+    if (!history.legalValid || history.legalKey != history.pos.key()) {
+        history.legalMoves.clear();
+        for (const auto& move : MoveList<LEGAL>(history.pos)) {
+            history.legalMoves.push_back(move_to_app_token(history.pos, move));
+        }
+        history.legalKey = history.pos.key();
+        history.legalValid = true;
+    }
+
+    return history.legalMoves;
+}
+
+// Formats legal moves and game-state metadata of a position as JSON.
+// 'moves' is the played move history the position was built from.
+static std::string position_state_json(PositionHistory& history, const char* moves) {
+    Position& pos = history.pos;
+    const std::vector<std::string>& legalMoves = legal_move_tokens(history);
+
+    const bool inCheck = bool(pos.checkers());
+    const bool bikjang = pos.bikjang();
+    const bool canPass = std::any_of(
+        legalMoves.begin(),
+        legalMoves.end(),
+        [](const std::string& move) { return is_pass_uci_move(move); });
+
+    Value result = VALUE_ZERO;
+    const bool immediateGameEnd = pos.is_immediate_game_end(result, 0);
+    const bool optionalGameEnd =
+        !immediateGameEnd && pos.is_optional_game_end(result, 0);
+    bool gameOver = immediateGameEnd || optionalGameEnd;
+    const bool noLegalMoves = legalMoves.empty();
+
+    if (!gameOver && noLegalMoves) {
+        result = inCheck ? pos.checkmate_value(0) : pos.stalemate_value(0);
+        gameOver = true;
+    }
+
+    std::string winner = "none";
+    if (gameOver) {
+        if (result == VALUE_DRAW) {
+            winner = "draw";
+        } else {
+            const bool sideToMoveWins = result > VALUE_ZERO;
+            const Color winnerColor =
+                sideToMoveWins ? pos.side_to_move() : ~pos.side_to_move();
+            winner = winnerColor == WHITE ? "blue" : "red";
+        }
+    }
+
+    std::string reason = "ongoing";
+    if (gameOver) {
+        if (noLegalMoves && inCheck) {
+            reason = "checkmate";
+        } else if (noLegalMoves) {
+            reason = "stalemate";
+        } else if (bikjang) {
+            reason = "bikjang";
+        } else if (moves != nullptr && moves[0] != '\0') {
+            std::string movesString(moves);
+            const auto lastSeparator = movesString.find_last_of(' ');
+            const std::string lastMove =
+                lastSeparator == std::string::npos
+                    ? movesString
+                    : movesString.substr(lastSeparator + 1);
+
+            if (is_pass_uci_move(lastMove)) {
+                reason = "pass";
+            }
+        }
+
+        if (reason == "ongoing" && optionalGameEnd) {
+            reason = "adjudication";
+        } else if (reason == "ongoing" && immediateGameEnd) {
+            reason = "immediate";
+        }
+    }
+
+    std::ostringstream json;
+    json << "{\"sideToMove\":\""
+         << (pos.side_to_move() == WHITE ? "blue" : "red")
+         << "\",\"legalMoves\":[";
+
+    for (size_t i = 0; i < legalMoves.size(); ++i) {
+        if (i > 0) {
+            json << ',';
+        }
+        json << '"' << escape_json(legalMoves[i]) << '"';
+    }
+
+    json << "],\"inCheck\":" << (inCheck ? "true" : "false")
+         << ",\"bikjang\":" << (bikjang ? "true" : "false")
+         << ",\"canPass\":" << (canPass ? "true" : "false")
+         << ",\"gameOver\":" << (gameOver ? "true" : "false")
+         << ",\"winner\":\"" << winner
+         << "\",\"reason\":\"" << reason << "\"}";
+
+    return json.str();
+}
+
 // Helper function to handle position command
 void handle_position(Position& pos, std::istringstream& is, StateListPtr& states) {
     Move m;
@@ -332,7 +994,26 @@ void handle_position(Position& pos, std::istringstream& is, StateListPtr& states
     LOGD("[MOVE_PARSE] Applied %d moves. Side to move: %s", move_count, (pos.side_to_move() == WHITE ? "WHITE" : "BLACK"));
 }
 
-// Helper function to handle go command
+// Writes "bestmove X ponder Y" for the principal variation 'pv' to cout_buffer
+static void write_bestmove(const Position& pos, const std::vector<Move>& pv) {
+    if (pv.empty() || pv[0] == MOVE_NONE) {
+        LOGD("[CMD] bestMove is MOVE_NONE");
+        return;
+    }
+
+    std::string moveStr = move_to_app_token(pos, pv[0]);
+    cout_buffer << "bestmove " << moveStr;
+    LOGD("[CMD] Found bestmove: %s", moveStr.c_str());
+
+    // Add ponder move if available
+    if (pv.size() > 1) {
+        cout_buffer << " ponder " << UCI::move(pos, pv[1]);
+    }
+    cout_buffer << std::endl;
+}
+
+// Helper function to handle go command: searches, unless the result is
+// cached, and writes the best move to cout_buffer
 void handle_go(Position& pos, std::istringstream& is, StateListPtr& states) {
     Search::LimitsType limits;
     std::string token;
@@ -352,10 +1033,116 @@ void handle_go(Position& pos, std::istringstream& is, StateListPtr& states) {
         else if (token == "depth")     is >> limits.depth;
         else if (token == "nodes")     is >> limits.nodes;
         else if (token == "movetime")  is >> limits.movetime;
+        else if (token == "latency")   is >> limits.latency;
         else if (token == "infinite")  limits.infinite = 1;
     }
 
+    ResultCache::Entry cached;
+    if (cacheable(limits) && ResultCache::probe(pos, Depth(limits.depth), cached)) {
+        LOGD("[CMD] Result cache hit");
+        write_bestmove(pos, cached.pv);
+        return;
+    }
+
     Threads.start_thinking(pos, states, limits, false);
+
+    LOGD("[CMD] Waiting for search finished...");
+    Threads.main()->wait_for_search_finished();
+    LOGD("[CMD] Search finished!");
+
+    // Use main thread directly since we're single-threaded
+    Thread* mainThread = Threads.main();
+    if (mainThread && !mainThread->rootMoves.empty()) {
+        store_result(pos, mainThread, limits);
+        write_bestmove(pos, mainThread->rootMoves[0].pv);
+    } else {
+        LOGD("[CMD] No root moves found!");
+    }
+}
+
+// Positions of the bench command in addition to the start position
+static const char* const BenchJanggiFens[] = {
+    "1Pbcka3/3nNn1c1/N2CaC3/1pB6/9/9/5P3/9/4K4/9 w - - 0 23",
+    "4kc3/4a4/3ac4/8b/9/9/2P1P4/C4A3/4A1r2/3CK1p2 b - - 0 1",
+    "rnba1abnr/4k4/1c5c1/p1p3p1p/4p4/6P2/P1P1P3P/1C5C1/4K4/RNBA1ABNR w - - 0 3",
+};
+
+static int64_t elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Helper function to handle bench command: "bench [depth N]" searches a few
+// positions of the current variant and reports, per position, the time of
+// the full Search::clear() and of the Search::reset() done before a new
+// analysis next to the time of the search itself.
+void handle_bench(std::istringstream& is) {
+    int depth = 10;
+    std::string token;
+    while (is >> token) {
+        if (token == "depth") {
+            is >> depth;
+        }
+    }
+
+    std::string error;
+    const Variant* variant = find_variant_by_name(normalized_variant_name(nullptr), error);
+    if (variant == nullptr) {
+        cout_buffer << error << std::endl;
+        return;
+    }
+
+    std::vector<std::string> fens{ variant->startFen };
+    if (variant->variantTemplate == "janggi") {
+        fens.insert(fens.end(), std::begin(BenchJanggiFens), std::end(BenchJanggiFens));
+    }
+
+    int64_t clearTotal = 0, resetTotal = 0, searchTotal = 0;
+    uint64_t nodesTotal = 0;
+    for (size_t i = 0; i < fens.size(); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
+            Search::clear();
+        }
+        const int64_t clearUs = elapsed_us(start);
+
+        start = std::chrono::steady_clock::now();
+        reset_search();
+        const int64_t resetUs = elapsed_us(start);
+
+        Position pos;
+        StateListPtr states(new std::deque<StateInfo>(1));
+        pos.set(variant, fens[i], false, &states->back(), Threads.main());
+
+        Search::LimitsType limits;
+        limits.startTime = now();
+        limits.depth = depth;
+
+        start = std::chrono::steady_clock::now();
+        search_and_wait(pos, states, limits);
+        const int64_t searchUs = elapsed_us(start);
+        const uint64_t nodes = Threads.nodes_searched();
+
+        cout_buffer << "position " << i + 1
+                    << " clear " << clearUs << " us"
+                    << " reset " << resetUs << " us"
+                    << " search " << searchUs << " us"
+                    << " nodes " << nodes << std::endl;
+
+        clearTotal += clearUs;
+        resetTotal += resetUs;
+        searchTotal += searchUs;
+        nodesTotal += nodes;
+    }
+
+    g_search_variant = variant;
+
+    cout_buffer << "total clear " << clearTotal << " us"
+                << " reset " << resetTotal << " us"
+                << " search " << searchTotal << " us"
+                << " nodes " << nodesTotal
+                << " nps " << nodesTotal * 1000000 / std::max(searchTotal, int64_t(1)) << std::endl;
 }
 
 // Helper function to handle setoption command
@@ -372,8 +1159,14 @@ void handle_setoption(std::istringstream& is) {
     while (is >> token)
         value += (value.empty() ? "" : " ") + token;
 
-    if (Options.count(name))
+    if (name == "Threads") {
+        stop_async_search();
+        set_threads_option(value);
+    }
+    else if (Options.count(name)) {
+        std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
         Options[name] = value;
+    }
 
     if (name == "UCI_Variant") {
         g_threads_initialized_command = false;
@@ -384,6 +1177,7 @@ void handle_setoption(std::istringstream& is) {
         std::string error;
         const Variant* variant = find_variant_by_name(value, error);
         if (variant != nullptr) {
+            std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
             PSQT::init(variant);
         } else {
             LOGE("%s", error.c_str());
@@ -391,6 +1185,108 @@ void handle_setoption(std::istringstream& is) {
     }
 }
 
+// An engine session owns its own state history, output buffer and search
+// thread, so that a move-legality query or a search on one session does not
+// queue behind a long search running on another or on the thread pool. The
+// search thread is outside of the pool, like the workers of batch analysis,
+// and only shares the TT and the result cache with it.
+struct StockfishSession {
+    std::mutex mutex;
+    std::string variantName;
+    PositionHistory history;
+    std::unique_ptr<Thread> worker; // Created by the first search
+    char output[8192];
+};
+
+// Returns a shared lock on the thread pool, creating the pool on first use,
+// so that positions can be bound to Threads.main() while the lock is held.
+static std::shared_lock<std::shared_mutex> acquire_thread_pool() {
+    while (true) {
+        std::shared_lock<std::shared_mutex> poolLock(g_pool_mutex);
+        if (Threads.size() > 0) {
+            return poolLock;
+        }
+        poolLock.unlock();
+
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+        if (Threads.size() == 0) {
+            ensure_thread_pool();
+            reset_search();
+        }
+    }
+}
+
+// Sets up 'fen' as the root position of the search thread of 'session',
+// creating the thread on first use. Callers must hold the session mutex and
+// g_pool_mutex shared.
+static Thread* session_worker(StockfishSession* session, const Variant* variant, const char* fen) {
+    if (!session->worker) {
+        session->worker.reset(new Thread(0));
+        session->worker->ownLimits = true;
+        session->worker->clear();
+    }
+
+    Thread* worker = session->worker.get();
+    worker->rootPos.set(variant, fen, false, &worker->rootState, worker);
+    return worker;
+}
+
+// Searches the root position of 'worker' to the given depth and waits for
+// the search to finish. Returns false if the position has no legal moves.
+static bool session_search(Thread* worker, int depth) {
+    worker->rootMoves.clear();
+    for (const auto& m : MoveList<LEGAL>(worker->rootPos)) {
+        worker->rootMoves.emplace_back(m);
+    }
+    if (worker->rootMoves.empty()) {
+        return false;
+    }
+
+    worker->nodes = worker->tbHits = worker->nmpMinPly = worker->bestMoveChanges = 0;
+    worker->ttProbes = worker->ttHits = 0;
+    worker->evalCacheProbes = worker->evalCacheHits = 0;
+    worker->rootDepth = worker->completedDepth = 0;
+    worker->depthLimit = std::max(depth, 1); // A search without limits would never finish
+
+    worker->start_searching();
+    worker->wait_for_search_finished();
+    return true;
+}
+
+// Appends one JSON line describing 'pos' and every legal move from it:
+// {"fen":...,"sideToMove":...,"inCheck":...,"moves":[{"move":...,"fen":...,
+// "check":...,"capture":...,"gameEnd":...},...]}. The flags of each move
+// describe the position after it.
+static void append_transitions_json(Position& pos, std::string& out) {
+    out += "{\"fen\":\"" + pos.fen()
+         + "\",\"sideToMove\":\"" + (pos.side_to_move() == WHITE ? "blue" : "red")
+         + "\",\"inCheck\":" + (pos.checkers() ? "true" : "false")
+         + ",\"moves\":[";
+
+    StateInfo st;
+    bool first = true;
+    for (const auto& move : MoveList<LEGAL>(pos)) {
+        const bool check = pos.gives_check(move);
+        const bool capture = pos.capture(move);
+
+        pos.do_move(move, st, check);
+        Value result;
+        const bool gameEnd = pos.is_game_end(result) || MoveList<LEGAL>(pos).size() == 0;
+        const std::string fen = pos.fen();
+        pos.undo_move(move);
+
+        out += first ? "{" : ",{";
+        out += "\"move\":\"" + move_to_app_token(pos, move)
+             + "\",\"fen\":\"" + fen
+             + "\",\"check\":" + (check ? "true" : "false")
+             + ",\"capture\":" + (capture ? "true" : "false")
+             + ",\"gameEnd\":" + (gameEnd ? "true" : "false") + "}";
+        first = false;
+    }
+
+    out += "]}\n";
+}
+
 // Cross-platform export macro
 #ifdef _WIN32
     #define EXPORT __declspec(dllexport)
@@ -428,8 +1324,13 @@ extern "C" {
             // CRITICAL: Set variant AFTER UCI init (UCI::init sets default to "chess")
             LOGD("[INIT] Setting options...");
             Options["UCI_Variant"] = std::string("janggi");
-            Options["Threads"] = 1;
-            Options["Hash"] = 16;  // Small hash table for faster init
+            // Keep the size and binding of a thread pool that survived a
+            // previous stockfish_cleanup()
+            set_threads_option(std::to_string(std::max(Threads.size(), size_t(1))));
+            Options["CPU Cluster"] = std::string(  Threads.cluster == CpuCluster::BIG    ? "big"
+                                                 : Threads.cluster == CpuCluster::LITTLE ? "little"
+                                                                                         : "all");
+            Options["Hash"] = std::string("16");  // Small hash table for faster init
             LOGD("[INIT] Options set");
 
             // Bitboards::init() is REQUIRED - cannot skip!
@@ -467,6 +1368,7 @@ extern "C" {
     // Sends a command to the engine and returns the output
     EXPORT const char* stockfish_command(const char* cmd) {
         std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
 
         // LOGD("[CMD] Received command: '%s'", cmd ? cmd : "NULL");
 
@@ -483,18 +1385,20 @@ extern "C" {
             try {
                 LOGD("[LAZY] Initializing threads...");
                 
-                LOGD("[LAZY] Threads.set(1)...");
-                Threads.set(1);
-                LOGD("[LAZY] Threads.set done!");
+                LOGD("[LAZY] ensure_thread_pool()...");
+                ensure_thread_pool();
+                LOGD("[LAZY] Thread pool ready!");
 
-                LOGD("[LAZY] Search::clear()...");
-                Search::clear();
+                LOGD("[LAZY] Search::reset()...");
+                reset_search();
 
                 const std::string variant_name = normalized_variant_name(nullptr);
                 LOGD("[LAZY] Setting initial %s position...", variant_name.c_str());
                 std::string error;
                 const Variant* variant = find_variant_by_name(variant_name, error);
                 if (variant != nullptr) {
+                    // A previous search may have taken ownership of g_states
+                    g_states = StateListPtr(new std::deque<StateInfo>(1));
                     g_pos.set(variant, variant->startFen, false, &g_states->back(), Threads.main());
                 } else {
                     LOGE("%s", error.c_str());
@@ -547,32 +1451,16 @@ extern "C" {
             else if (token == "go") {
                 LOGD("[CMD] Handling go...");
                 handle_go(g_pos, is, g_states);
-                
-                LOGD("[CMD] Waiting for search finished...");
-                Threads.main()->wait_for_search_finished();
-                LOGD("[CMD] Search finished!");
-
-                // Use main thread directly since we're single-threaded
-                Thread* mainThread = Threads.main();
-                if (mainThread && !mainThread->rootMoves.empty()) {
-                    Move bestMove = mainThread->rootMoves[0].pv[0];
-                    if (bestMove != MOVE_NONE) {
-                    std::string moveStr = move_to_app_token(g_pos, bestMove);
-                    cout_buffer << "bestmove " << moveStr;
-                    LOGD("[CMD] Found bestmove: %s", moveStr.c_str());
-
-                        // Add ponder move if available
-                        if (mainThread->rootMoves[0].pv.size() > 1) {
-                            Move ponderMove = mainThread->rootMoves[0].pv[1];
-                            cout_buffer << " ponder " << UCI::move(g_pos, ponderMove);
-                        }
-                        cout_buffer << std::endl;
-                    } else {
-                        LOGD("[CMD] bestMove is MOVE_NONE");
-                    }
-                } else {
-                    LOGD("[CMD] No root moves found!");
-                }
+            }
+            else if (token == "bench") {
+                handle_bench(is);
+            }
+            else if (token == "stats") {
+#ifdef SEARCH_STATS
+                cout_buffer << Threads.search_stats() << std::endl;
+#else
+                cout_buffer << "error: Search statistics not available, build with SEARCH_STATS" << std::endl;
+#endif
             }
             else if (token == "setoption") {
                 handle_setoption(is);
@@ -588,7 +1476,7 @@ extern "C" {
             }
             else if (token == "ucinewgame") {
                 LOGD("[CMD] Handling ucinewgame...");
-                Search::clear();
+                reset_search();
                 g_states = StateListPtr(new std::deque<StateInfo>(1));
                 std::string error;
                 const std::string variant_name = normalized_variant_name(nullptr);
@@ -638,6 +1526,7 @@ extern "C" {
     // Returns: "cp 300 bestmove e9f9" or "mate 5 bestmove a1a2" or "error: ..."
     EXPORT const char* stockfish_analyze(const char* variant, const char* fen, int depth) {
         std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
 
         // LOGD("[ANALYZE] FEN: %s, depth: %d", fen ? fen : "NULL", depth);
 
@@ -653,12 +1542,13 @@ extern "C" {
         if (!g_threads_initialized_analyze) {
             try {
                 LOGD("[ANALYZE] Lazy init threads...");
-                Threads.set(1);
-                Search::clear();
+                ensure_thread_pool();
+                reset_search();
                 std::string error;
                 const std::string variant_name = normalized_variant_name(variant);
                 const Variant* resolvedVariant = find_variant_by_name(variant_name, error);
                 if (resolvedVariant != nullptr) {
+                    g_states = StateListPtr(new std::deque<StateInfo>(1));
                     g_pos.set(resolvedVariant, resolvedVariant->startFen, false, &g_states->back(), Threads.main());
                 } else {
                     LOGE("[ANALYZE] %s", error.c_str());
@@ -683,9 +1573,6 @@ extern "C" {
         }
 
         try {
-            // Clear search state before each analysis to prevent memory corruption
-            Search::clear();
-            
             // Set up position from FEN
             std::string error;
             const std::string variant_name = normalized_variant_name(variant);
@@ -697,63 +1584,14 @@ extern "C" {
                 return output_buffer;
             }
 
+            // Keep TT and histories from the previous analysis of the same variant
+            prepare_search(resolvedVariant);
+
             // Create fresh state for each analysis
             g_states = StateListPtr(new std::deque<StateInfo>(1));
             g_pos.set(resolvedVariant, fen, false, &g_states->back(), Threads.main());
 
-            // LOGD("[ANALYZE] Position set, starting search depth=%d", depth);
-
-            // Set up search limits
-            Search::LimitsType limits;
-            limits.startTime = now();
-            limits.depth = depth;
-
-            // Suppress verbose search info output during API analysis calls.
-            ScopedCoutRedirect silence_stdout(&g_null_buffer);
-
-            // Start search
-            Threads.start_thinking(g_pos, g_states, limits, false);
-            Threads.main()->wait_for_search_finished();
-
-            // Extract score from rootMoves
-            Thread* mainThread = Threads.main();
-            if (mainThread == nullptr || mainThread->rootMoves.empty()) {
-                LOGE("[ANALYZE] No root moves");
-                std::strncpy(output_buffer, "error: No root moves", sizeof(output_buffer) - 1);
-                output_buffer[sizeof(output_buffer) - 1] = '\0';
-                return output_buffer;
-            }
-
-            Value score = mainThread->rootMoves[0].score;
-            Move bestMove = mainThread->rootMoves[0].pv[0];
-
-            // Build output string
-            std::stringstream ss;
-
-            // Check if it's a mate score
-            if (score >= VALUE_MATE_IN_MAX_PLY) {
-                // Positive mate: we are winning
-                int mateIn = (VALUE_MATE - score + 1) / 2;
-                ss << "mate " << mateIn;
-            } else if (score <= VALUE_MATED_IN_MAX_PLY) {
-                // Negative mate: we are losing
-                int mateIn = (-VALUE_MATE - score) / 2;
-                ss << "mate " << mateIn;
-            } else {
-                // Centipawn score
-                ss << "cp " << static_cast<int>(score);
-            }
-
-            // Add best move
-            if (bestMove != MOVE_NONE) {
-                ss << " bestmove " << move_to_app_token(g_pos, bestMove);
-            }
-
-            std::string output = ss.str();
-            // LOGD("[ANALYZE] Result: %s", output.c_str());
-            std::strncpy(output_buffer, output.c_str(), sizeof(output_buffer) - 1);
-            output_buffer[sizeof(output_buffer) - 1] = '\0';
-            return output_buffer;
+            return write_output(output_buffer, run_analysis(g_pos, g_states, depth));
 
         } catch (const std::exception& e) {
             LOGE("[ANALYZE] Exception: %s", e.what());
@@ -767,6 +1605,23 @@ extern "C" {
         }
     }
 
+    // Same as stockfish_analyze, but writes the result into a caller-allocated
+    // struct. Returns STOCKFISH_OK or a negative STOCKFISH_ERROR_* code.
+    EXPORT int stockfish_analyze_result(const char* variant, const char* fen, int depth, StockfishAnalysis* out) {
+        return analyze_fen_to_result(variant, fen, depth, 0, out);
+    }
+
+    // Searches the top k root moves to the given depth and writes them with
+    // their scores, depths and PVs into out->pv, best first. k is limited to
+    // STOCKFISH_MAX_PV_LINES.
+    EXPORT int stockfish_analyze_multipv(const char* variant, const char* fen, int depth, int k, StockfishAnalysis* out) {
+        if (k < 1) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        return analyze_fen_to_result(variant, fen, depth, std::min(k, STOCKFISH_MAX_PV_LINES), out);
+    }
+
     // Return legal moves and game-state metadata for a position built from
     // a root FEN plus the played move history.
     EXPORT const char* stockfish_position_state(const char* variant, const char* root_fen, const char* moves) {
@@ -779,7 +1634,7 @@ extern "C" {
         }
 
         Position pos;
-        StateListPtr states(new std::deque<StateInfo>(1));
+        StateListPtr states;
         const std::string variant_name = normalized_variant_name(variant);
         if (!ensure_threads_initialized(
                 g_threads_initialized_state,
@@ -794,131 +1649,754 @@ extern "C" {
 
         try {
             std::string error;
-            if (!build_position_from_history(
-                    pos,
-                    states,
-                    variant_name,
-                    root_fen,
-                    moves,
-                    error)) {
+            if (!replay_history(g_state_history, variant_name, root_fen, moves, error)) {
                 std::strncpy(output_buffer, error.c_str(), sizeof(output_buffer) - 1);
                 output_buffer[sizeof(output_buffer) - 1] = '\0';
                 return output_buffer;
             }
 
-            std::vector<std::string> legalMoves;
-            legalMoves.reserve(128);
-            for (const auto& move : MoveList<LEGAL>(pos)) {
-                legalMoves.push_back(move_to_app_token(pos, move));
-            }
+            const std::string output = position_state_json(g_state_history, moves);
+            std::strncpy(output_buffer, output.c_str(), sizeof(output_buffer) - 1);
+            output_buffer[sizeof(output_buffer) - 1] = '\0';
+            return output_buffer;
+        } catch (const std::exception& e) {
+            std::snprintf(
+                output_buffer,
+                sizeof(output_buffer),
+                "error: Exception - %s",
+                e.what());
+            return output_buffer;
+        } catch (...) {
+            std::strncpy(output_buffer, "error: Unknown exception", sizeof(output_buffer) - 1);
+            output_buffer[sizeof(output_buffer) - 1] = '\0';
+            return output_buffer;
+        }
+    }
 
-            const bool inCheck = bool(pos.checkers());
-            const bool bikjang = pos.bikjang();
-            const bool canPass = std::any_of(
-                legalMoves.begin(),
-                legalMoves.end(),
-                [](const std::string& move) { return is_pass_uci_move(move); });
+    // For each of the 'count' (fens[i], moves[i]) pairs, builds the position
+    // after the space-separated move list (which may be null) and writes one
+    // JSON line with its legal moves, the FEN after each move and the check,
+    // capture and game-end flags, or {"error":...} if the pair is invalid.
+    // Returns the length of the full output, which is truncated if it does
+    // not fit into 'out_size' bytes, or a negative STOCKFISH_ERROR_* code.
+    EXPORT int stockfish_legal_moves_batch(
+        const char* variant,
+        const char* const* fens,
+        const char* const* moves,
+        int count,
+        char* out,
+        int out_size) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (fens == nullptr || count < 0 || (out == nullptr && out_size > 0)) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
 
-            Value result = VALUE_ZERO;
-            const bool immediateGameEnd = pos.is_immediate_game_end(result, 0);
-            const bool optionalGameEnd =
-                !immediateGameEnd && pos.is_optional_game_end(result, 0);
-            bool gameOver = immediateGameEnd || optionalGameEnd;
-            const bool noLegalMoves = legalMoves.empty();
+        try {
+            std::string variantName;
+            {
+                std::lock_guard<std::mutex> lock(g_engine_mutex);
+                variantName = normalized_variant_name(variant);
+            }
 
-            if (!gameOver && noLegalMoves) {
-                result = inCheck ? pos.checkmate_value(0) : pos.stalemate_value(0);
-                gameOver = true;
+            std::string error;
+            if (find_variant_by_name(variantName, error) == nullptr) {
+                return STOCKFISH_ERROR_UNKNOWN_VARIANT;
             }
 
-            std::string winner = "none";
-            if (gameOver) {
-                if (result == VALUE_DRAW) {
-                    winner = "draw";
+            std::shared_lock<std::shared_mutex> poolLock = acquire_thread_pool();
+
+            std::string output;
+            Position pos;
+            StateListPtr states;
+            for (int i = 0; i < count; ++i) {
+                if (build_position_from_history(
+                        pos,
+                        states,
+                        variantName,
+                        fens[i],
+                        moves != nullptr ? moves[i] : nullptr,
+                        error)) {
+                    append_transitions_json(pos, output);
                 } else {
-                    const bool sideToMoveWins = result > VALUE_ZERO;
-                    const Color winnerColor =
-                        sideToMoveWins ? pos.side_to_move() : ~pos.side_to_move();
-                    winner = winnerColor == WHITE ? "blue" : "red";
+                    output += "{\"error\":\"" + escape_json(error) + "\"}\n";
                 }
             }
 
-            std::string reason = "ongoing";
-            if (gameOver) {
-                if (noLegalMoves && inCheck) {
-                    reason = "checkmate";
-                } else if (noLegalMoves) {
-                    reason = "stalemate";
-                } else if (bikjang) {
-                    reason = "bikjang";
-                } else if (moves != nullptr && moves[0] != '\0') {
-                    std::string movesString(moves);
-                    const auto lastSeparator = movesString.find_last_of(' ');
-                    const std::string lastMove =
-                        lastSeparator == std::string::npos
-                            ? movesString
-                            : movesString.substr(lastSeparator + 1);
-
-                    if (is_pass_uci_move(lastMove)) {
-                        reason = "pass";
-                    }
-                }
+            if (out_size > 0) {
+                const size_t len = std::min(output.size(), size_t(out_size) - 1);
+                std::memcpy(out, output.data(), len);
+                out[len] = '\0';
+            }
+            return int(output.size());
+        } catch (const std::exception& e) {
+            LOGE("[BATCH] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
 
-                if (reason == "ongoing" && optionalGameEnd) {
-                    reason = "adjudication";
-                } else if (reason == "ongoing" && immediateGameEnd) {
-                    reason = "immediate";
-                }
+    // Runs the proof-number mate solver for a checking mate of the side to
+    // move in at most 'mate_in' moves, bounded by 'max_nodes' tree nodes (0 for
+    // the default), and writes the status, every key move and the solution
+    // tree with all defences as JSON. Returns the length of the full output,
+    // which is truncated if it does not fit into 'out_size' bytes, or a
+    // negative STOCKFISH_ERROR_* code.
+    EXPORT int stockfish_mate_search(
+        const char* variant,
+        const char* fen,
+        int mate_in,
+        int64_t max_nodes,
+        char* out,
+        int out_size) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (mate_in < 1 || max_nodes < 0 || (out == nullptr && out_size > 0)) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        try {
+            std::string variantName;
+            {
+                std::lock_guard<std::mutex> lock(g_engine_mutex);
+                variantName = normalized_variant_name(variant);
+            }
+
+            std::shared_lock<std::shared_mutex> poolLock = acquire_thread_pool();
+
+            std::string error;
+            Position pos;
+            StateListPtr states;
+            if (!build_position_from_history(pos, states, variantName, fen, nullptr, error)) {
+                return find_variant_by_name(variantName, error) == nullptr
+                    ? STOCKFISH_ERROR_UNKNOWN_VARIANT
+                    : STOCKFISH_ERROR_INVALID_ARGUMENT;
+            }
+
+            Mate::Result result = Mate::search(pos, mate_in, max_nodes > 0 ? uint64_t(max_nodes) : 1000000);
+            const std::string output = Mate::to_json(pos, result);
+
+            if (out_size > 0) {
+                const size_t len = std::min(output.size(), size_t(out_size) - 1);
+                std::memcpy(out, output.data(), len);
+                out[len] = '\0';
+            }
+            return int(output.size());
+        } catch (const std::exception& e) {
+            LOGE("[MATE] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
+
+    // Analyses the positions listed in 'input_path', one FEN per line with
+    // optional "depth N"/"nodes N" overrides, on 'workers' independent search
+    // threads and streams one JSON line per job to 'output_path'. Returns the
+    // number of jobs or a negative STOCKFISH_ERROR_* code.
+    EXPORT int stockfish_batch_analyze(
+        const char* variant,
+        const char* input_path,
+        const char* output_path,
+        int workers,
+        int depth,
+        int64_t nodes) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (input_path == nullptr || output_path == nullptr || workers < 1) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        try {
+            std::string error;
+            const Variant* resolvedVariant = find_variant_by_name(normalized_variant_name(variant), error);
+            if (resolvedVariant == nullptr) {
+                return STOCKFISH_ERROR_UNKNOWN_VARIANT;
             }
 
-            std::ostringstream json;
-            json << "{\"sideToMove\":\""
-                 << (pos.side_to_move() == WHITE ? "blue" : "red")
-                 << "\",\"legalMoves\":[";
+            std::ifstream in(input_path);
+            std::ofstream out(output_path);
+            if (!in || !out) {
+                return STOCKFISH_ERROR_IO;
+            }
+
+            ensure_thread_pool();
+
+            return int(Batch::run(resolvedVariant, in, out, size_t(workers), depth, nodes));
+        } catch (const std::exception& e) {
+            LOGE("[BATCH] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
 
-            for (size_t i = 0; i < legalMoves.size(); ++i) {
-                if (i > 0) {
-                    json << ',';
+    // Starts searching the position after 'moves' (space-separated, may be
+    // null) from 'fen' and returns without waiting for the search. The search
+    // is limited by 'depth' and/or 'movetime_ms' and runs until stopped if
+    // both are 0. If 'callback' is not null, it is called on the search thread
+    // after every completed iteration and once more when the search finishes.
+    // A search started earlier is stopped first. Returns STOCKFISH_OK or a
+    // negative STOCKFISH_ERROR_* code.
+    EXPORT int stockfish_search_start(
+        const char* variant,
+        const char* fen,
+        const char* moves,
+        int depth,
+        int movetime_ms,
+        StockfishProgressCallback callback,
+        void* user_data) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (fen == nullptr || depth < 0 || movetime_ms < 0) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        try {
+            const std::string variantName = normalized_variant_name(variant);
+            std::string error;
+            const Variant* resolvedVariant = find_variant_by_name(variantName, error);
+            if (resolvedVariant == nullptr) {
+                return STOCKFISH_ERROR_UNKNOWN_VARIANT;
+            }
+
+            ensure_thread_pool();
+
+            stop_async_search();
+            prepare_search(resolvedVariant);
+
+            Position pos;
+            StateListPtr states;
+            if (!build_position_from_history(pos, states, variantName, fen, moves, error)) {
+                LOGE("[SEARCH] %s", error.c_str());
+                return STOCKFISH_ERROR_INVALID_ARGUMENT;
+            }
+
+            Search::LimitsType limits;
+            limits.startTime = now();
+            limits.depth = depth;
+            limits.movetime = movetime_ms;
+            limits.infinite = depth == 0 && movetime_ms == 0;
+            begin_async_search(limits, callback, user_data);
+
+            Threads.start_thinking(pos, states, limits, false);
+            return STOCKFISH_OK;
+        } catch (const std::exception& e) {
+            LOGE("[SEARCH] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
+
+    // Copies the result of the last completed iteration, or the final result
+    // once the search has finished, of the search started by
+    // stockfish_search_start into 'out' (which may be null) without waiting.
+    // Returns STOCKFISH_SEARCH_RUNNING, STOCKFISH_SEARCH_DONE or
+    // STOCKFISH_SEARCH_IDLE if no search was started.
+    EXPORT int stockfish_search_poll(StockfishAnalysis* out) {
+        std::lock_guard<std::mutex> lock(g_async.mutex);
+
+        if (!g_async.active) {
+            return STOCKFISH_SEARCH_IDLE;
+        }
+        if (out != nullptr) {
+            *out = g_async.progress;
+        }
+        return g_async.finished ? STOCKFISH_SEARCH_DONE : STOCKFISH_SEARCH_RUNNING;
+    }
+
+    // Stops the search started by stockfish_search_start, waits for it and
+    // copies its final result into 'out' (which may be null). Returns
+    // STOCKFISH_SEARCH_DONE or STOCKFISH_SEARCH_IDLE if no search was started.
+    EXPORT int stockfish_search_stop(StockfishAnalysis* out) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+
+        {
+            std::lock_guard<std::mutex> searchLock(g_search_mutex);
+            stop_async_search();
+        }
+
+        return stockfish_search_poll(out);
+    }
+
+    // Starts pondering on the position after 'moves' from 'fen', the position
+    // right after the engine's own move, while the user thinks. The search
+    // runs on the predicted reply: the second move of the last search's PV if
+    // that search played into this position, otherwise the hash move. Its
+    // token is copied into 'ponder_token' (STOCKFISH_TOKEN_SIZE bytes, may be
+    // null). 'depth', 'movetime_ms' and 'callback' are as for
+    // stockfish_search_start; the movetime counts from now, so on a hit the
+    // time the user took is already spent. Returns STOCKFISH_OK, or
+    // STOCKFISH_ERROR_NO_MOVES if there is no reply to ponder on.
+    EXPORT int stockfish_ponder_start(
+        const char* variant,
+        const char* fen,
+        const char* moves,
+        int depth,
+        int movetime_ms,
+        StockfishProgressCallback callback,
+        void* user_data,
+        char* ponder_token) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (fen == nullptr || depth < 0 || movetime_ms < 0) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        try {
+            const std::string variantName = normalized_variant_name(variant);
+            std::string error;
+            const Variant* resolvedVariant = find_variant_by_name(variantName, error);
+            if (resolvedVariant == nullptr) {
+                return STOCKFISH_ERROR_UNKNOWN_VARIANT;
+            }
+
+            ensure_thread_pool();
+            stop_async_search();
+            prepare_search(resolvedVariant);
+
+            Position pos;
+            StateListPtr states;
+            if (!build_position_from_history(pos, states, variantName, fen, moves, error)) {
+                LOGE("[PONDER] %s", error.c_str());
+                return STOCKFISH_ERROR_INVALID_ARGUMENT;
+            }
+
+            // The last search already has the reply in its PV if it played
+            // into this position
+            Move reply = MOVE_NONE;
+            Thread* mainThread = Threads.main();
+            if (!mainThread->rootMoves.empty() && mainThread->rootMoves[0].pv.size() > 1) {
+                const Search::RootMove& rm = mainThread->rootMoves[0];
+                StateInfo st;
+                mainThread->rootPos.do_move(rm.pv[0], st);
+                if (mainThread->rootPos.key() == pos.key()) {
+                    reply = rm.pv[1];
                 }
-                json << '"' << escape_json(legalMoves[i]) << '"';
+                mainThread->rootPos.undo_move(rm.pv[0]);
             }
 
-            json << "],\"inCheck\":" << (inCheck ? "true" : "false")
-                 << ",\"bikjang\":" << (bikjang ? "true" : "false")
-                 << ",\"canPass\":" << (canPass ? "true" : "false")
-                 << ",\"gameOver\":" << (gameOver ? "true" : "false")
-                 << ",\"winner\":\"" << winner
-                 << "\",\"reason\":\"" << reason << "\"}";
+            if (reply == MOVE_NONE) {
+                bool ttHit;
+                TTEntry* tte = TT.probe(pos.key(), ttHit);
+                reply = ttHit ? tte->move() : MOVE_NONE;
+            }
 
-            const std::string output = json.str();
-            std::strncpy(output_buffer, output.c_str(), sizeof(output_buffer) - 1);
-            output_buffer[sizeof(output_buffer) - 1] = '\0';
-            return output_buffer;
+            if (reply == MOVE_NONE || !MoveList<LEGAL>(pos).contains(reply)) {
+                return STOCKFISH_ERROR_NO_MOVES;
+            }
+
+            g_ponder.appToken = move_to_app_token(pos, reply);
+            g_ponder.uciToken = UCI::move(pos, reply);
+            if (ponder_token != nullptr) {
+                std::strncpy(ponder_token, g_ponder.appToken.c_str(), STOCKFISH_TOKEN_SIZE - 1);
+                ponder_token[STOCKFISH_TOKEN_SIZE - 1] = '\0';
+            }
+
+            states->emplace_back();
+            pos.do_move(reply, states->back());
+
+            Search::LimitsType limits;
+            limits.startTime = now();
+            limits.depth = depth;
+            limits.movetime = movetime_ms;
+            limits.infinite = depth == 0 && movetime_ms == 0;
+            begin_async_search(limits, callback, user_data);
+
+            Threads.start_thinking(pos, states, limits, true);
+            g_ponder.active = true;
+            return STOCKFISH_OK;
         } catch (const std::exception& e) {
-            std::snprintf(
-                output_buffer,
-                sizeof(output_buffer),
-                "error: Exception - %s",
-                e.what());
-            return output_buffer;
+            LOGE("[PONDER] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
         } catch (...) {
-            std::strncpy(output_buffer, "error: Unknown exception", sizeof(output_buffer) - 1);
-            output_buffer[sizeof(output_buffer) - 1] = '\0';
-            return output_buffer;
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
+
+    // Tells the ponder search the move the user played. On a hit it turns
+    // into the normal search, keeping what it found so far, and the result
+    // is reported as for stockfish_search_start. On a miss it is stopped
+    // without reporting its result, and the caller starts a new search.
+    // Returns 1 on a hit, 0 on a miss, or a negative STOCKFISH_ERROR_* code
+    // if the engine is not pondering.
+    EXPORT int stockfish_ponder_hit(const char* move) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (move == nullptr) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        if (!g_ponder.active) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        std::string token(move);
+        std::transform(token.begin(), token.end(), token.begin(),
+                       [](unsigned char c) { return char(std::tolower(c)); });
+
+        if (token == g_ponder.appToken || token == g_ponder.uciToken) {
+            g_ponder.active = false;
+            Threads.main()->ponder = false;
+            return 1;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(g_async.mutex);
+            g_async.callback = nullptr;
+        }
+        stop_async_search();
+        {
+            std::lock_guard<std::mutex> lock(g_async.mutex);
+            g_async.active = false;
+        }
+        return 0;
+    }
+
+    // Creates a session for the given variant (the current UCI_Variant if
+    // null or empty). Returns null if the engine is not initialized or the
+    // variant is unknown.
+    EXPORT StockfishSession* stockfish_session_create(const char* variant) {
+        if (!g_initialized) {
+            LOGE("[SESSION] Engine not initialized");
+            return nullptr;
+        }
+
+        std::string variantName;
+        {
+            std::lock_guard<std::mutex> lock(g_engine_mutex);
+            variantName = normalized_variant_name(variant);
+        }
+
+        std::string error;
+        if (find_variant_by_name(variantName, error) == nullptr) {
+            LOGE("[SESSION] %s", error.c_str());
+            return nullptr;
+        }
+
+        StockfishSession* session = new StockfishSession();
+        session->variantName = variantName;
+        session->output[0] = '\0';
+        return session;
+    }
+
+    // Destroys a session. The caller must make sure no other call on the
+    // session is still in progress.
+    EXPORT void stockfish_session_destroy(StockfishSession* session) {
+        delete session;
+    }
+
+    // Same as stockfish_analyze, on the search thread and output buffer of a
+    // session. The search runs at full strength with one PV and does not wait
+    // for searches of the thread pool or of other sessions.
+    EXPORT const char* stockfish_session_analyze(StockfishSession* session, const char* fen, int depth) {
+        if (session == nullptr) {
+            return "error: Null session";
+        }
+
+        std::lock_guard<std::mutex> lock(session->mutex);
+
+        if (!g_initialized) {
+            return write_output(session->output, "error: Engine not initialized");
+        }
+        if (fen == nullptr) {
+            return write_output(session->output, "error: Null FEN");
+        }
+
+        try {
+            std::string error;
+            const Variant* variant = find_variant_by_name(session->variantName, error);
+            if (variant == nullptr) {
+                return write_output(session->output, error);
+            }
+
+            std::shared_lock<std::shared_mutex> poolLock = acquire_thread_pool();
+            Thread* worker = session_worker(session, variant, fen);
+
+            Search::LimitsType limits;
+            limits.depth = depth;
+            limits.multiPV = 1;
+
+            // A cached result counts as a full TT hit
+            ResultCache::Entry cached;
+            if (cacheable(limits) && ResultCache::probe(worker->rootPos, Depth(depth), cached)) {
+                return write_output(session->output, format_analysis(worker->rootPos, cached.score, cached.pv[0], 1000));
+            }
+
+            if (!session_search(worker, depth)) {
+                return write_output(session->output, "error: No root moves");
+            }
+
+            store_result(worker->rootPos, worker, limits);
+            const Search::RootMove& best = worker->rootMoves[0];
+            return write_output(session->output, format_analysis(worker->rootPos, best.score, best.pv[0], tt_hit_permille(worker)));
+        } catch (const std::exception& e) {
+            LOGE("[SESSION] Exception: %s", e.what());
+            return write_output(session->output, std::string("error: Exception - ") + e.what());
+        } catch (...) {
+            return write_output(session->output, "error: Unknown exception");
+        }
+    }
+
+    // Same as stockfish_analyze_result, on the search thread of a session
+    EXPORT int stockfish_session_analyze_result(StockfishSession* session, const char* fen, int depth, StockfishAnalysis* out) {
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (session == nullptr || fen == nullptr || out == nullptr) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        std::memset(out, 0, sizeof(StockfishAnalysis));
+        std::lock_guard<std::mutex> lock(session->mutex);
+
+        try {
+            std::string error;
+            const Variant* variant = find_variant_by_name(session->variantName, error);
+            if (variant == nullptr) {
+                return STOCKFISH_ERROR_UNKNOWN_VARIANT;
+            }
+
+            std::shared_lock<std::shared_mutex> poolLock = acquire_thread_pool();
+            Thread* worker = session_worker(session, variant, fen);
+
+            Search::LimitsType limits;
+            limits.startTime = now();
+            limits.depth = depth;
+            limits.multiPV = 1;
+
+            ResultCache::Entry cached;
+            if (cacheable(limits) && ResultCache::probe(worker->rootPos, Depth(depth), cached)) {
+                fill_cached_analysis(worker->rootPos, cached, out);
+                return STOCKFISH_OK;
+            }
+
+            if (!session_search(worker, depth)) {
+                return STOCKFISH_ERROR_NO_MOVES;
+            }
+
+            store_result(worker->rootPos, worker, limits);
+            return fill_analysis(worker, limits, out);
+        } catch (const std::exception& e) {
+            LOGE("[SESSION] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
+
+    // Same as stockfish_position_state, on the position and output buffer of
+    // a session. Does not wait for searches running on other sessions.
+    EXPORT const char* stockfish_session_position_state(StockfishSession* session, const char* root_fen, const char* moves) {
+        if (session == nullptr) {
+            return "error: Null session";
+        }
+
+        std::lock_guard<std::mutex> lock(session->mutex);
+
+        if (!g_initialized) {
+            return write_output(session->output, "error: Engine not initialized");
+        }
+
+        try {
+            std::shared_lock<std::shared_mutex> poolLock = acquire_thread_pool();
+
+            std::string error;
+            if (!replay_history(session->history, session->variantName, root_fen, moves, error)) {
+                return write_output(session->output, error);
+            }
+
+            return write_output(session->output, position_state_json(session->history, moves));
+        } catch (const std::exception& e) {
+            return write_output(session->output, std::string("error: Exception - ") + e.what());
+        } catch (...) {
+            return write_output(session->output, "error: Unknown exception");
+        }
+    }
+
+    // Resizes the thread pool to 'threads' search threads bound to the
+    // STOCKFISH_CLUSTER_* cores. The transposition table is kept, and the
+    // pool keeps its size and binding across stockfish_cleanup().
+    EXPORT int stockfish_set_threads(int threads, int cluster) {
+        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (threads < 1 || threads > 512 || cluster < STOCKFISH_CLUSTER_ALL || cluster > STOCKFISH_CLUSTER_LITTLE) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        try {
+            static const char* const ClusterNames[] = { "all", "big", "little" };
+
+            stop_async_search();
+            set_threads_option(std::to_string(threads));
+            std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
+            Options["CPU Cluster"] = std::string(ClusterNames[cluster]);
+            return STOCKFISH_OK;
+        } catch (const std::exception& e) {
+            LOGE("[THREADS] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
+
+    // Copies the statistics of the last search into 'out'. Returns
+    // STOCKFISH_SEARCH_RUNNING while a search started by stockfish_search_start
+    // is running, or STOCKFISH_ERROR_NOT_SUPPORTED if the engine is built
+    // without SEARCH_STATS.
+    EXPORT int stockfish_last_search_stats(StockfishSearchStats* out) {
+        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (out == nullptr) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+#ifdef SEARCH_STATS
+        {
+            std::lock_guard<std::mutex> asyncLock(g_async.mutex);
+            if (g_async.active && !g_async.finished) {
+                return STOCKFISH_SEARCH_RUNNING;
+            }
+        }
+
+        ensure_thread_pool();
+        const SearchStats stats = Threads.search_stats();
+        const int64_t threadTime = stats.time * int64_t(stats.threads);
+
+        std::memset(out, 0, sizeof(*out));
+        out->nodes = stats.nodes;
+        out->qnodes = stats.qnodes;
+        out->ttProbes = stats.ttProbes;
+        out->ttHits = stats.ttHits;
+        out->ttCollisions = stats.ttCollisions;
+        static_assert(STOCKFISH_STATS_CUTOFF_SLOTS == SearchStats::CutoffSlots, "Cutoff slots differ");
+        for (int i = 0; i < STOCKFISH_STATS_CUTOFF_SLOTS; ++i) {
+            out->cutoffs[i] = stats.cutoffs[i];
+        }
+        out->nullMoveTries = stats.nullMoveTries;
+        out->nullMoveCutoffs = stats.nullMoveCutoffs;
+        out->lmrSearches = stats.lmrSearches;
+        out->lmrResearches = stats.lmrResearches;
+        out->evalCalls = stats.evalCalls;
+        out->evalCacheProbes = stats.evalCacheProbes;
+        out->evalCacheHits = stats.evalCacheHits;
+        out->threads = uint32_t(stats.threads);
+        out->timeUs = uint64_t(stats.time / 1000);
+        out->movegenUs = uint64_t(stats.movegenTime / 1000);
+        out->evalUs = uint64_t(stats.evalTime / 1000);
+        out->searchUs = uint64_t(std::max<int64_t>(0, threadTime - stats.movegenTime - stats.evalTime) / 1000);
+        return STOCKFISH_OK;
+#else
+        std::memset(out, 0, sizeof(*out));
+        return STOCKFISH_ERROR_NOT_SUPPORTED;
+#endif
+    }
+
+    // Sets the number of results kept by the result cache, 0 disables it
+    EXPORT int stockfish_result_cache_resize(int entries) {
+        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        if (entries < 0) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        ResultCache::resize(size_t(entries));
+        return STOCKFISH_OK;
+    }
+
+    // Adds the results saved in 'path' to the result cache. Returns the number
+    // of results read or an error code.
+    EXPORT int stockfish_result_cache_load(const char* path) {
+        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (path == nullptr) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        try {
+            ensure_thread_pool();
+            const int count = ResultCache::load(path);
+            return count < 0 ? STOCKFISH_ERROR_IO : count;
+        } catch (const std::exception& e) {
+            LOGE("[RESULT_CACHE] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
+        }
+    }
+
+    // Writes the result cache to 'path'. Returns the number of results written
+    // or an error code.
+    EXPORT int stockfish_result_cache_save(const char* path) {
+        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
+
+        if (!g_initialized) {
+            return STOCKFISH_ERROR_NOT_INITIALIZED;
+        }
+        if (path == nullptr) {
+            return STOCKFISH_ERROR_INVALID_ARGUMENT;
+        }
+
+        try {
+            ensure_thread_pool();
+            const int count = ResultCache::save(path);
+            return count < 0 ? STOCKFISH_ERROR_IO : count;
+        } catch (const std::exception& e) {
+            LOGE("[RESULT_CACHE] Exception: %s", e.what());
+            return STOCKFISH_ERROR_EXCEPTION;
+        } catch (...) {
+            return STOCKFISH_ERROR_EXCEPTION;
         }
     }
 
     // Clean shutdown
     EXPORT void stockfish_cleanup() {
         std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::lock_guard<std::mutex> searchLock(g_search_mutex);
 
         if (!g_initialized) {
             return;
         }
 
         try {
-            Search::clear();
-            Threads.set(0);
+            stop_async_search();
+            // The thread pool is kept for the next stockfish_init()
+            {
+                std::unique_lock<std::shared_mutex> poolLock(g_pool_mutex);
+                Search::clear();
+            }
             if (old_cout_streambuf) {
                 std::cout.rdbuf(old_cout_streambuf);
                 old_cout_streambuf = nullptr;
@@ -927,6 +2405,12 @@ extern "C" {
             g_threads_initialized_analyze = false;
             g_threads_initialized_state = false;
             g_states = StateListPtr(new std::deque<StateInfo>(1));
+            g_state_history.valid = false;
+            {
+                std::lock_guard<std::mutex> asyncLock(g_async.mutex);
+                g_async.active = false;
+                g_async.callback = nullptr;
+            }
             g_initialized = false;
         }
         catch (...) {
@@ -0,0 +1,149 @@
+#ifndef C_API_H_INCLUDED
+#define C_API_H_INCLUDED
+
+#include <stdint.h>
+
+// Fixed-layout types of the C API. Results are written into caller-allocated
+// structs, so callers do not need to parse strings from the output buffer.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    STOCKFISH_OK = 0,
+    STOCKFISH_ERROR_NOT_INITIALIZED = -1,
+    STOCKFISH_ERROR_INVALID_ARGUMENT = -2,
+    STOCKFISH_ERROR_UNKNOWN_VARIANT = -3,
+    STOCKFISH_ERROR_NO_MOVES = -4,
+    STOCKFISH_ERROR_EXCEPTION = -5,
+    STOCKFISH_ERROR_IO = -6,
+    STOCKFISH_ERROR_NOT_SUPPORTED = -7
+};
+
+// States of the search started by stockfish_search_start
+enum {
+    STOCKFISH_SEARCH_IDLE = 0,
+    STOCKFISH_SEARCH_RUNNING = 1,
+    STOCKFISH_SEARCH_DONE = 2
+};
+
+// CPU cores the search threads run on, see stockfish_set_threads
+enum {
+    STOCKFISH_CLUSTER_ALL = 0,
+    STOCKFISH_CLUSTER_BIG = 1,
+    STOCKFISH_CLUSTER_LITTLE = 2
+};
+
+#define STOCKFISH_MAX_PV_LINES 8
+#define STOCKFISH_MAX_PV_MOVES 32
+#define STOCKFISH_TOKEN_SIZE 8 // "a10i10" plus terminator, zero padded
+
+#define STOCKFISH_STATS_CUTOFF_SLOTS 8
+
+typedef struct StockfishSession StockfishSession;
+
+// One principal variation. Scores are from the side to move: 'mate' is the
+// number of moves to mate (negative when getting mated) or 0, in which case
+// 'score' holds the evaluation in centipawns.
+typedef struct {
+    int32_t score;
+    int32_t mate;
+    int32_t depth;
+    int32_t selDepth;
+    int32_t length;
+    uint32_t moves[STOCKFISH_MAX_PV_MOVES]; // Packed engine Move values
+    char tokens[STOCKFISH_MAX_PV_MOVES][STOCKFISH_TOKEN_SIZE];
+} StockfishPvLine;
+
+typedef struct {
+    int32_t score;
+    int32_t mate;
+    int32_t depth;
+    int32_t selDepth;
+    uint64_t nodes;
+    uint64_t nps;
+    uint32_t timeMs;
+    uint32_t ttHitPermille;
+    uint32_t bestmove;
+    uint32_t ponder;
+    char bestmoveToken[STOCKFISH_TOKEN_SIZE];
+    char ponderToken[STOCKFISH_TOKEN_SIZE];
+    int32_t pvCount;
+    StockfishPvLine pv[STOCKFISH_MAX_PV_LINES];
+} StockfishAnalysis;
+
+// Counters of the last search, see stockfish_last_search_stats. 'cutoffs'
+// counts beta cutoffs at the n-th move of a node, the last slot all later
+// moves. Move generation and evaluation times are summed over the threads;
+// 'searchUs' is the rest of the threads' time. Classical evaluations are
+// looked up in the per-thread eval cache first, see the Eval Cache option.
+typedef struct {
+    uint64_t nodes;
+    uint64_t qnodes;
+    uint64_t ttProbes;
+    uint64_t ttHits;
+    uint64_t ttCollisions;
+    uint64_t cutoffs[STOCKFISH_STATS_CUTOFF_SLOTS];
+    uint64_t nullMoveTries;
+    uint64_t nullMoveCutoffs;
+    uint64_t lmrSearches;
+    uint64_t lmrResearches;
+    uint64_t evalCalls;
+    uint32_t threads;
+    uint64_t timeUs;
+    uint64_t movegenUs;
+    uint64_t evalUs;
+    uint64_t searchUs;
+    uint64_t evalCacheProbes;
+    uint64_t evalCacheHits;
+} StockfishSearchStats;
+
+// Progress callback of stockfish_search_start. Called on the search thread
+// with the result after each completed iteration, and with 'finished' set
+// once the search is over. 'info' is only valid during the call.
+typedef void (*StockfishProgressCallback)(const StockfishAnalysis* info, int finished, void* userData);
+
+void stockfish_init(void);
+const char* stockfish_command(const char* cmd);
+const char* stockfish_analyze(const char* variant, const char* fen, int depth);
+int stockfish_analyze_result(const char* variant, const char* fen, int depth, StockfishAnalysis* out);
+int stockfish_analyze_multipv(const char* variant, const char* fen, int depth, int k, StockfishAnalysis* out);
+const char* stockfish_position_state(const char* variant, const char* root_fen, const char* moves);
+int stockfish_legal_moves_batch(const char* variant, const char* const* fens, const char* const* moves,
+                                int count, char* out, int out_size);
+int stockfish_mate_search(const char* variant, const char* fen, int mate_in, int64_t max_nodes,
+                          char* out, int out_size);
+int stockfish_batch_analyze(const char* variant, const char* input_path, const char* output_path,
+                            int workers, int depth, int64_t nodes);
+
+int stockfish_set_threads(int threads, int cluster);
+int stockfish_last_search_stats(StockfishSearchStats* out);
+
+// Results of depth-limited searches are kept in an LRU cache, see resultcache.h.
+// Load and save return the number of results or an error code.
+int stockfish_result_cache_resize(int entries);
+int stockfish_result_cache_load(const char* path);
+int stockfish_result_cache_save(const char* path);
+
+int stockfish_search_start(const char* variant, const char* fen, const char* moves, int depth, int movetime_ms,
+                           StockfishProgressCallback callback, void* user_data);
+int stockfish_search_poll(StockfishAnalysis* out);
+int stockfish_search_stop(StockfishAnalysis* out);
+int stockfish_ponder_start(const char* variant, const char* fen, const char* moves, int depth, int movetime_ms,
+                           StockfishProgressCallback callback, void* user_data, char* ponder_token);
+int stockfish_ponder_hit(const char* move);
+
+StockfishSession* stockfish_session_create(const char* variant);
+void stockfish_session_destroy(StockfishSession* session);
+const char* stockfish_session_analyze(StockfishSession* session, const char* fen, int depth);
+int stockfish_session_analyze_result(StockfishSession* session, const char* fen, int depth, StockfishAnalysis* out);
+const char* stockfish_session_position_state(StockfishSession* session, const char* root_fen, const char* moves);
+
+void stockfish_cleanup(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // #ifndef C_API_H_INCLUDED
@@ -77,6 +77,12 @@ namespace Endgames {
 
   void init() {
 
+#if defined(JANGGI_ONLY) || !defined(PRECOMPUTED_MAGICS)
+    // None of the specialized endgames apply to Janggi material, and without
+    // precomputed magics the bishop attacks their positions need are not set up
+    return;
+#endif
+
     add<KPK>("KPK");
     add<KNNK>("KNNK");
     add<KBNK>("KBNK");
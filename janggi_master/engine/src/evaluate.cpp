@@ -233,6 +233,13 @@ namespace {
 // Threshold for lazy and space evaluation
 constexpr Value LazyThreshold1 = Value(1565);
 constexpr Value LazyThreshold2 = Value(1102);
+// Janggi's mobility and king terms are larger, but the terms skipped by the
+// second exit are smaller. From Janggi self-play evaluations: 0.04% of those
+// skipped by the first exit change sign, none of the second (|terms| < 250).
+// Lazy evaluation is off for Janggi though, an SPRT at 5000 nodes per move
+// accepted H0 at about -66 Elo (548 games, 211-23-314).
+constexpr Value JanggiLazyThreshold1 = Value(1000);
+constexpr Value JanggiLazyThreshold2 = Value(500);
 constexpr Value SpaceThreshold = Value(11551);
 
 // KingAttackWeights[PieceType] contains king attack weights by piece type
@@ -333,8 +340,61 @@ constexpr int VirtualCheck = 600;
 
 #undef S
 
+// GenericRules gives the evaluation the rules of the variant of the position.
+// JanggiRules folds them at compile time for the variants that share the rules
+// of Janggi (see Variant::janggiRules), so that the terms of other variants
+// are compiled out of its evaluation.
+struct GenericRules {
+  static constexpr Value lazyThreshold1 = LazyThreshold1;
+  static constexpr Value lazyThreshold2 = LazyThreshold2;
+  static bool lazy_eval(const Position &pos) { return pos.variant()->lazyEval; }
+  static bool captures_to_hand(const Position &pos) { return pos.captures_to_hand(); }
+  static bool check_counting(const Position &pos) { return pos.check_counting(); }
+  static bool two_boards(const Position &pos) { return pos.two_boards(); }
+  static bool piece_drops(const Position &pos) { return pos.piece_drops(); }
+  static bool seirawan_gating(const Position &pos) { return pos.seirawan_gating(); }
+  static bool must_capture(const Position &pos) { return pos.must_capture(); }
+  static bool is_chess960(const Position &pos) { return pos.is_chess960(); }
+  static bool blast_on_capture(const Position &pos) { return pos.blast_on_capture(); }
+  static EnclosingRule flip_enclosed_pieces(const Position &pos) { return pos.flip_enclosed_pieces(); }
+  static int connect_n(const Position &pos) { return pos.connect_n(); }
+  static Value extinction_value(const Position &pos) { return pos.extinction_value(); }
+  static Bitboard flag_region(const Position &pos, Color c) { return pos.flag_region(c); }
+  static bool makpong(const Position &pos) { return pos.makpong(); }
+  static bool piece_demotion(const Position &pos) { return pos.piece_demotion(); }
+  static PieceType king_type(const Position &pos) { return pos.king_type(); }
+  static bool checking_permitted(const Position &pos) { return pos.checking_permitted(); }
+  static PieceType promoted_piece_type(const Position &pos, PieceType pt) { return pos.promoted_piece_type(pt); }
+  static Bitboard attacks_from(const Position &pos, Color c, PieceType pt, Square s) { return pos.attacks_from(c, pt, s); }
+};
+
+struct JanggiRules {
+  static constexpr Value lazyThreshold1 = JanggiLazyThreshold1;
+  static constexpr Value lazyThreshold2 = JanggiLazyThreshold2;
+  static constexpr bool lazy_eval(const Position &) { return false; }
+  static constexpr bool captures_to_hand(const Position &) { return false; }
+  static constexpr bool check_counting(const Position &) { return false; }
+  static constexpr bool two_boards(const Position &) { return false; }
+  static constexpr bool piece_drops(const Position &) { return false; }
+  static constexpr bool seirawan_gating(const Position &) { return false; }
+  static constexpr bool must_capture(const Position &) { return false; }
+  static constexpr bool is_chess960(const Position &) { return false; }
+  static constexpr bool blast_on_capture(const Position &) { return false; }
+  static constexpr EnclosingRule flip_enclosed_pieces(const Position &) { return NO_ENCLOSING; }
+  static constexpr int connect_n(const Position &) { return 0; }
+  static constexpr Value extinction_value(const Position &) { return VALUE_NONE; }
+  static constexpr Bitboard flag_region(const Position &, Color) { return Bitboard(0); }
+  static constexpr bool makpong(const Position &) { return false; }
+  static constexpr bool piece_demotion(const Position &) { return false; }
+  static constexpr PieceType king_type(const Position &) { return WAZIR; }
+  static constexpr bool checking_permitted(const Position &) { return true; }
+  static constexpr PieceType promoted_piece_type(const Position &, PieceType) { return NO_PIECE_TYPE; }
+  // Read from the attack maps that do_move() keeps up to date
+  static Bitboard attacks_from(const Position &pos, Color, PieceType, Square s) { return pos.piece_attacks(s); }
+};
+
 // Evaluation class computes and stores attacks tables and other working data
-template <Tracing T> class Evaluation {
+template <Tracing T, typename Rules = GenericRules> class Evaluation {
 
 public:
   Evaluation() = delete;
@@ -396,7 +456,7 @@ private:
 // Evaluation::initialize() computes king and pawn attacks, and the king ring
 // bitboard for a given color. This is done at the beginning of the evaluation.
 
-template <Tracing T> template <Color Us> void Evaluation<T>::initialize() {
+template <Tracing T, typename Rules> template <Color Us> void Evaluation<T, Rules>::initialize() {
 
   constexpr Color Them = ~Us;
   constexpr Direction Up = pawn_push(Us);
@@ -414,7 +474,7 @@ template <Tracing T> template <Color Us> void Evaluation<T>::initialize() {
   // Squares occupied by those pawns, by our king or queen, by blockers to
   // attacks on our king or controlled by enemy pawns are excluded from the
   // mobility area.
-  if (pos.must_capture())
+  if (Rules::must_capture(pos))
     mobilityArea[Us] = AllSquares;
   else
     mobilityArea[Us] =
@@ -427,7 +487,7 @@ template <Tracing T> template <Color Us> void Evaluation<T>::initialize() {
 
   // Initialize attackedBy[] for king and pawns
   attackedBy[Us][KING] =
-      pos.count<KING>(Us) ? pos.attacks_from(Us, KING, ksq) : Bitboard(0);
+      pos.count<KING>(Us) ? Rules::attacks_from(pos, Us, KING, ksq) : Bitboard(0);
   attackedBy[Us][PAWN] = pe->pawn_attacks(Us);
   attackedBy[Us][SHOGI_PAWN] = shift<Up>(pos.pieces(Us, SHOGI_PAWN));
   attackedBy[Us][ALL_PIECES] =
@@ -461,9 +521,9 @@ template <Tracing T> template <Color Us> void Evaluation<T>::initialize() {
 
 // Evaluation::pieces() scores pieces of a given color and type
 
-template <Tracing T>
+template <Tracing T, typename Rules>
 template <Color Us>
-Score Evaluation<T>::pieces(PieceType Pt) {
+Score Evaluation<T, Rules>::pieces(PieceType Pt) {
 
   constexpr Color Them = ~Us;
   constexpr Direction Down = -pawn_push(Us);
@@ -486,10 +546,11 @@ Score Evaluation<T>::pieces(PieceType Pt) {
     b = Pt == ROOK && !pos.diagonal_lines()
             ? attacks_bb<ROOK>(s, pos.pieces() ^ pos.pieces(QUEEN) ^
                                       pos.pieces(Us, ROOK))
-            : pos.attacks_from(Us, Pt, s);
+            : Rules::attacks_from(pos, Us, Pt, s);
 
     // Restrict mobility to actual squares of board
     b &= pos.board_bb(Us, Pt);
+    Bitboard attacks = b;
 
     if (pos.blockers_for_king(Us) & s)
       b &= line_bb(pos.square<KING>(Us), s);
@@ -511,9 +572,13 @@ Score Evaluation<T>::pieces(PieceType Pt) {
              (attacks_bb<BISHOP>(s, pos.pieces(PAWN)) & kingRing[Them]))
       score += BishopOnKingRing;
 
+    // The quiet moves of most fairy pieces, like all of Janggi, are the
+    // empty squares they attack, which saves generating them again
     if (Pt > QUEEN)
       b = (b & pos.pieces()) |
-          (pos.moves_from(Us, Pt, s) & ~pos.pieces() & pos.board_bb());
+          ((SymmetricMoveTypes & Pt) && !(pos.double_step_region(Us) & s)
+               ? attacks & ~pos.pieces()
+               : pos.moves_from(Us, Pt, s) & ~pos.pieces() & pos.board_bb());
 
     int mob = popcount(b & mobilityArea[Us]);
     if (Pt <= QUEEN)
@@ -522,21 +587,21 @@ Score Evaluation<T>::pieces(PieceType Pt) {
       mobility[Us] += MaxMobility * (mob - 2) / (8 + mob);
 
     // Piece promotion bonus
-    if (pos.promoted_piece_type(Pt) != NO_PIECE_TYPE) {
+    if (Rules::promoted_piece_type(pos, Pt) != NO_PIECE_TYPE) {
       Bitboard zone = pos.promotion_zone(Us);
       if (zone & (b | s))
-        score += make_score(PieceValue[MG][pos.promoted_piece_type(Pt)] -
+        score += make_score(PieceValue[MG][Rules::promoted_piece_type(pos, Pt)] -
                                 PieceValue[MG][Pt],
-                            PieceValue[EG][pos.promoted_piece_type(Pt)] -
+                            PieceValue[EG][Rules::promoted_piece_type(pos, Pt)] -
                                 PieceValue[EG][Pt]) /
                  (zone & s && b ? 6 : 12);
-    } else if (pos.piece_demotion() && pos.unpromoted_piece_on(s))
+    } else if (Rules::piece_demotion(pos) && pos.unpromoted_piece_on(s))
       score -=
           make_score(
               PieceValue[MG][Pt] - PieceValue[MG][pos.unpromoted_piece_on(s)],
               PieceValue[EG][Pt] - PieceValue[EG][pos.unpromoted_piece_on(s)]) /
           4;
-    else if (pos.captures_to_hand() && pos.unpromoted_piece_on(s))
+    else if (Rules::captures_to_hand(pos) && pos.unpromoted_piece_on(s))
       score +=
           make_score(
               PieceValue[MG][Pt] - PieceValue[MG][pos.unpromoted_piece_on(s)],
@@ -544,7 +609,7 @@ Score Evaluation<T>::pieces(PieceType Pt) {
           8;
 
     // Penalty if the piece is far from the kings in drop variants
-    if ((pos.captures_to_hand() || pos.two_boards()) && pos.count<KING>(Them) &&
+    if ((Rules::captures_to_hand(pos) || Rules::two_boards(pos)) && pos.count<KING>(Them) &&
         pos.count<KING>(Us)) {
       if (!(b & (kingRing[Us] | kingRing[Them])))
         score -= KingProximity * distance(s, pos.square<KING>(Us)) *
@@ -609,7 +674,7 @@ Score Evaluation<T>::pieces(PieceType Pt) {
         // An important Chess960 pattern: a cornered bishop blocked by a
         // friendly pawn diagonally in front of it is a very serious problem,
         // especially when that pawn is also blocked.
-        if (pos.is_chess960() && (s == relative_square(Us, SQ_A1) ||
+        if (Rules::is_chess960(pos) && (s == relative_square(Us, SQ_A1) ||
                                   s == relative_square(Us, SQ_H1))) {
           Direction d = pawn_push(Us) + (file_of(s) == FILE_A ? EAST : WEST);
           if (pos.piece_on(s + d) == make_piece(Us, PAWN))
@@ -654,9 +719,9 @@ Score Evaluation<T>::pieces(PieceType Pt) {
 }
 
 // Evaluation::hand() scores pieces of a given color and type in hand
-template <Tracing T>
+template <Tracing T, typename Rules>
 template <Color Us>
-Score Evaluation<T>::hand(PieceType pt) {
+Score Evaluation<T, Rules>::hand(PieceType pt) {
 
   constexpr Color Them = ~Us;
 
@@ -681,11 +746,11 @@ Score Evaluation<T>::hand(PieceType pt) {
         DropMobility * popcount(b & theirHalf & ~attackedBy[Them][ALL_PIECES]);
 
     // Bonus for Kyoto shogi style drops of promoted pieces
-    if (pos.promoted_piece_type(pt) != NO_PIECE_TYPE && pos.drop_promoted())
-      score += make_score(std::max(PieceValue[MG][pos.promoted_piece_type(pt)] -
+    if (Rules::promoted_piece_type(pos, pt) != NO_PIECE_TYPE && pos.drop_promoted())
+      score += make_score(std::max(PieceValue[MG][Rules::promoted_piece_type(pos, pt)] -
                                        PieceValue[MG][pt],
                                    VALUE_ZERO),
-                          std::max(PieceValue[EG][pos.promoted_piece_type(pt)] -
+                          std::max(PieceValue[EG][Rules::promoted_piece_type(pos, pt)] -
                                        PieceValue[EG][pt],
                                    VALUE_ZERO)) /
                4 * pos.count_in_hand(Us, pt);
@@ -695,7 +760,7 @@ Score Evaluation<T>::hand(PieceType pt) {
       mobility[Us] += make_score(500, 500) * popcount(b);
 
     // Reduce score if there is a deficit of gates
-    if (pos.seirawan_gating() && !pos.piece_drops() &&
+    if (Rules::seirawan_gating(pos) && !Rules::piece_drops(pos) &&
         pos.count_in_hand(Us, ALL_PIECES) > popcount(pos.gates(Us)))
       score -= make_score(200, 900) / pos.count_in_hand(Us, ALL_PIECES) *
                (pos.count_in_hand(Us, ALL_PIECES) - popcount(pos.gates(Us)));
@@ -711,7 +776,7 @@ Score Evaluation<T>::hand(PieceType pt) {
 
 // Evaluation::king() assigns bonuses and penalties to a king of a given color
 
-template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
+template <Tracing T, typename Rules> template <Color Us> Score Evaluation<T, Rules>::king() const {
 
   constexpr Color Them = ~Us;
   Rank r = relative_rank(
@@ -719,12 +784,12 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
       pos.max_rank());
   Bitboard Camp = pos.board_bb() & ~forward_ranks_bb(Us, r);
 
-  if (!pos.count<KING>(Us) || !pos.checking_permitted() ||
+  if (!pos.count<KING>(Us) || !Rules::checking_permitted(pos) ||
       pos.checkmate_value() != -VALUE_MATE)
     return SCORE_ZERO;
 
   Bitboard weak, b1, b2, b3, safe, unsafeChecks = 0;
-  Bitboard queenChecks, knightChecks, pawnChecks, otherChecks;
+  Bitboard knightChecks, pawnChecks, otherChecks;
   int kingDanger = 0;
   const Square ksq = pos.square<KING>(Us);
 
@@ -738,16 +803,15 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
 
   // Analyse the safe enemy's checks which are possible on next move
   safe = ~pos.pieces(Them);
-  if (!pos.check_counting() || pos.checks_remaining(Them) > 1)
+  if (!Rules::check_counting(pos) || pos.checks_remaining(Them) > 1)
     safe &= ~attackedBy[Us][ALL_PIECES] | (weak & attackedBy2[Them]);
 
   b1 = attacks_bb<ROOK>(ksq, pos.pieces() ^ pos.pieces(Us, QUEEN));
   b2 = attacks_bb<BISHOP>(ksq, pos.pieces() ^ pos.pieces(Us, QUEEN));
 
-  std::function<Bitboard(Color, PieceType)> get_attacks = [this](Color c,
-                                                                 PieceType pt) {
+  auto get_attacks = [this](Color c, PieceType pt) {
     return attackedBy[c][pt] |
-           (pos.piece_drops() && pos.count_in_hand(c, pt) > 0
+           (Rules::piece_drops(pos) && pos.count_in_hand(c, pt) > 0
                 ? pos.drop_region(c, pt) & ~pos.pieces()
                 : Bitboard(0));
   };
@@ -780,7 +844,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
         unsafeChecks |= knightChecks;
       break;
     case PAWN:
-      if (pos.piece_drops() && pos.count_in_hand(Them, pt) > 0) {
+      if (Rules::piece_drops(pos) && pos.count_in_hand(Them, pt) > 0) {
         pawnChecks = attacks_bb(Us, pt, ksq, pos.pieces()) & ~pos.pieces() &
                      pos.board_bb();
         if (pawnChecks & safe)
@@ -790,9 +854,9 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
       }
       break;
     case SHOGI_PAWN:
-      if (pos.promoted_piece_type(pt)) {
+      if (Rules::promoted_piece_type(pos, pt)) {
         otherChecks =
-            attacks_bb(Us, pos.promoted_piece_type(pt), ksq, pos.pieces()) &
+            attacks_bb(Us, Rules::promoted_piece_type(pos, pt), ksq, pos.pieces()) &
             attackedBy[Them][pt] & pos.promotion_zone(Them) & pos.board_bb();
         if (otherChecks & safe)
           kingDanger +=
@@ -815,7 +879,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
   }
 
   // Virtual piece drops
-  if (pos.two_boards() && pos.piece_drops()) {
+  if (Rules::two_boards(pos) && Rules::piece_drops(pos)) {
     for (PieceSet ps = pos.piece_types(); ps;) {
       PieceType pt = pop_lsb(ps);
       if (pos.count_in_hand(Them, pt) <= 0 &&
@@ -830,7 +894,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
     }
   }
 
-  if (pos.check_counting())
+  if (Rules::check_counting(pos))
     kingDanger += kingDanger * 7 / (3 + pos.checks_remaining(Them));
 
   Square s = file_of(ksq) == FILE_A           ? ksq + EAST
@@ -854,17 +918,17 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
       kingAttackersCountInHand[Them] * kingAttackersWeight[Them] +
       kingAttackersCount[Them] * kingAttackersWeightInHand[Them] +
       183 * popcount(kingRing[Us] & (weak | ~pos.board_bb(Us, KING))) *
-          (1 + pos.captures_to_hand() + pos.check_counting()) +
-      148 * popcount(unsafeChecks) * (1 + pos.check_counting()) +
+          (1 + Rules::captures_to_hand(pos) + Rules::check_counting(pos)) +
+      148 * popcount(unsafeChecks) * (1 + Rules::check_counting(pos)) +
       98 * popcount(pos.blockers_for_king(Us)) +
       69 * kingAttacksCount[Them] *
-          (2 + 8 * pos.check_counting() + pos.captures_to_hand()) / 2 +
+          (2 + 8 * Rules::check_counting(pos) + Rules::captures_to_hand(pos)) / 2 +
       3 * kingFlankAttack * kingFlankAttack / 8 +
-      mg_value(mobility[Them] - mobility[Us]) * int(!pos.captures_to_hand()) -
-      873 * !(pos.major_pieces(Them) || pos.captures_to_hand()) * 2 /
-          (2 + 2 * pos.check_counting() + 2 * pos.two_boards() +
-           2 * pos.makpong() +
-           (pos.king_type() != KING) * (pos.diagonal_lines() ? 1 : 2)) -
+      mg_value(mobility[Them] - mobility[Us]) * int(!Rules::captures_to_hand(pos)) -
+      873 * !(pos.major_pieces(Them) || Rules::captures_to_hand(pos)) * 2 /
+          (2 + 2 * Rules::check_counting(pos) + 2 * Rules::two_boards(pos) +
+           2 * Rules::makpong(pos) +
+           (Rules::king_type(pos) != KING) * (pos.diagonal_lines() ? 1 : 2)) -
       100 * bool(attackedBy[Us][KNIGHT] & attackedBy[Us][KING]) -
       6 * mg_value(score) / 8 - 4 * kingFlankDefense + 37;
 
@@ -880,18 +944,18 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
 
   // Penalty if king flank is under attack, potentially moving toward the king
   score -= FlankAttacks * kingFlankAttack *
-           (1 + 5 * pos.captures_to_hand() + pos.check_counting());
+           (1 + 5 * Rules::captures_to_hand(pos) + Rules::check_counting(pos));
 
-  if (pos.check_counting())
+  if (Rules::check_counting(pos))
     score +=
         make_score(0, mg_value(score) * 2 / (2 + pos.checks_remaining(Them)));
 
-  if (pos.king_type() == WAZIR)
+  if (Rules::king_type(pos) == WAZIR)
     score += make_score(0, mg_value(score) / 2);
 
   // For drop games, king danger is independent of game phase, but dependent on
   // material density
-  if (pos.captures_to_hand() || pos.two_boards())
+  if (Rules::captures_to_hand(pos) || Rules::two_boards(pos))
     score = make_score(mg_value(score) * me->material_density() / 11000,
                        mg_value(score) * me->material_density() / 11000);
 
@@ -904,7 +968,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::king() const {
 // Evaluation::threats() assigns bonuses according to the types of the
 // attacking and the attacked pieces.
 
-template <Tracing T> template <Color Us> Score Evaluation<T>::threats() const {
+template <Tracing T, typename Rules> template <Color Us> Score Evaluation<T, Rules>::threats() const {
 
   constexpr Color Them = ~Us;
   constexpr Direction Up = pawn_push(Us);
@@ -914,7 +978,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::threats() const {
   Score score = SCORE_ZERO;
 
   // Bonuses for variants with mandatory captures
-  if (pos.must_capture()) {
+  if (Rules::must_capture(pos)) {
     // Penalties for possible captures
     Bitboard captures = attackedBy[Us][ALL_PIECES] & pos.pieces(Them);
     if (captures)
@@ -937,7 +1001,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::threats() const {
   }
 
   // Extinction threats
-  if (pos.extinction_value() == -VALUE_MATE) {
+  if (Rules::extinction_value(pos) == -VALUE_MATE) {
     Bitboard bExt = attackedBy[Us][ALL_PIECES] & pos.pieces(Them);
     for (PieceSet ps = pos.extinction_piece_types(); ps;) {
       PieceType pt = pop_lsb(ps);
@@ -946,7 +1010,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::threats() const {
       int denom = std::max(
           pos.count_with_hand(Them, pt) - pos.extinction_piece_count(), 1);
       // Explosion threats
-      if (pos.blast_on_capture()) {
+      if (Rules::blast_on_capture(pos)) {
         int evasions = popcount(((attackedBy[Them][pt] & ~pos.pieces(Them)) |
                                  pos.pieces(Them, pt)) &
                                 ~attackedBy[Us][ALL_PIECES]) *
@@ -1060,14 +1124,14 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::threats() const {
 // Evaluation::passed() evaluates the passed pawns and candidate passed
 // pawns of the given color.
 
-template <Tracing T> template <Color Us> Score Evaluation<T>::passed() const {
+template <Tracing T, typename Rules> template <Color Us> Score Evaluation<T, Rules>::passed() const {
 
   constexpr Color Them = ~Us;
   constexpr Direction Up = pawn_push(Us);
   constexpr Direction Down = -Up;
 
   auto king_proximity = [&](Color c, Square s) {
-    return pos.extinction_value() == VALUE_MATE ? 0
+    return Rules::extinction_value(pos) == VALUE_MATE ? 0
            : pos.count<KING>(c) ? std::min(distance(pos.square<KING>(c), s), 5)
                                 : 5;
   };
@@ -1177,7 +1241,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::passed() const {
                          (QueenValueEg - PawnValueEg));
 
   // Score passed shogi pawns
-  PieceType pt = pos.promoted_piece_type(SHOGI_PAWN);
+  PieceType pt = Rules::promoted_piece_type(pos, SHOGI_PAWN);
   if (pt != NO_PIECE_TYPE) {
     b = pos.pieces(Us, SHOGI_PAWN);
     while (b) {
@@ -1208,7 +1272,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::passed() const {
 // friendly pawn are counted twice. Finally, the space bonus is multiplied by a
 // weight which decreases according to occupancy.
 
-template <Tracing T> template <Color Us> Score Evaluation<T>::space() const {
+template <Tracing T, typename Rules> template <Color Us> Score Evaluation<T, Rules>::space() const {
 
   bool pawnsOnly = !(pos.pieces(Us) ^ pos.pieces(Us, PAWN));
 
@@ -1246,9 +1310,9 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::space() const {
   int weight = pos.count<ALL_PIECES>(Us) - 3 + std::min(pe->blocked_count(), 9);
   Score score = make_score(bonus * weight * weight / 16, 0);
 
-  if (pos.flag_region(Us))
+  if (Rules::flag_region(pos, Us))
     score +=
-        make_score(200, 200) * popcount(behind & safe & pos.flag_region(Us));
+        make_score(200, 200) * popcount(behind & safe & Rules::flag_region(pos, Us));
 
   if constexpr (T)
     Trace::add(SPACE, Us, score);
@@ -1259,7 +1323,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::space() const {
 // Evaluation::variant() computes variant-specific evaluation bonuses for a
 // given side.
 
-template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
+template <Tracing T, typename Rules> template <Color Us> Score Evaluation<T, Rules>::variant() const {
 
   constexpr Color Them = ~Us;
   constexpr Direction Down = pawn_push(Them);
@@ -1267,9 +1331,9 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
   Score score = SCORE_ZERO;
 
   // Capture the flag
-  if (pos.flag_region(Us)) {
+  if (Rules::flag_region(pos, Us)) {
     Bitboard ctfPieces = pos.pieces(Us, pos.flag_piece(Us));
-    Bitboard ctfTargets = pos.flag_region(Us) & pos.board_bb();
+    Bitboard ctfTargets = Rules::flag_region(pos, Us) & pos.board_bb();
     Bitboard onHold = 0;
     Bitboard onHold2 = 0;
     Bitboard processed = 0;
@@ -1314,14 +1378,14 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
   }
 
   // nCheck
-  if (pos.check_counting()) {
+  if (Rules::check_counting(pos)) {
     int remainingChecks = pos.checks_remaining(Us);
     assert(remainingChecks > 0);
     score += make_score(3600, 1000) / (remainingChecks * remainingChecks);
   }
 
   // Extinction
-  if (pos.extinction_value() != VALUE_NONE) {
+  if (Rules::extinction_value(pos) != VALUE_NONE) {
     for (PieceSet ps = pos.extinction_piece_types(); ps;) {
       PieceType pt = pop_lsb(ps);
       if (pt != ALL_PIECES) {
@@ -1329,11 +1393,11 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
         int denom =
             std::max(pos.count(Us, pt) - pos.extinction_piece_count(), 1);
         if (pos.count(Them, pt) >= pos.extinction_opponent_piece_count() ||
-            pos.two_boards())
+            Rules::two_boards(pos))
           score += make_score(1000000 / (500 + PieceValue[MG][pt]),
                               1000000 / (500 + PieceValue[EG][pt])) /
-                   (denom * denom) * (pos.extinction_value() / VALUE_MATE);
-      } else if (pos.extinction_value() == VALUE_MATE) {
+                   (denom * denom) * (Rules::extinction_value(pos) / VALUE_MATE);
+      } else if (Rules::extinction_value(pos) == VALUE_MATE) {
         // Losing chess variant bonus
         score +=
             make_score(pos.non_pawn_material(Us), pos.non_pawn_material(Us)) /
@@ -1369,7 +1433,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
   }
 
   // Connect-n
-  if (pos.connect_n() > 0) {
+  if (Rules::connect_n(pos) > 0) {
     // Calculate eligible pieces for connection once.
     // Still consider all opponent pieces as blocking.
     Bitboard connectPiecesUs = 0;
@@ -1384,25 +1448,25 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
     {
       // Find sufficiently large gaps
       Bitboard b = pos.board_bb() & ~pos.pieces(Them);
-      for (int i = 1; i < pos.connect_n(); i++)
+      for (int i = 1; i < Rules::connect_n(pos); i++)
         b &= shift(d, b);
       // Count number of pieces per gap
       while (b) {
         Square s = pop_lsb(b);
         int c = 0;
-        for (int j = 0; j < pos.connect_n(); j++)
+        for (int j = 0; j < Rules::connect_n(pos); j++)
           if (connectPiecesUs & (s - j * d))
             c++;
-        score += make_score(200, 200) * c / (pos.connect_n() - c) /
-                 (pos.connect_n() - c);
+        score += make_score(200, 200) * c / (Rules::connect_n(pos) - c) /
+                 (Rules::connect_n(pos) - c);
       }
     }
   }
 
   // Potential piece flips (Reversi)
-  if (pos.flip_enclosed_pieces()) {
+  if (Rules::flip_enclosed_pieces(pos)) {
     // Stable pieces
-    if (pos.flip_enclosed_pieces() == REVERSI) {
+    if (Rules::flip_enclosed_pieces(pos) == REVERSI) {
       Bitboard edges = (FileABB | file_bb(pos.max_file()) | Rank1BB |
                         rank_bb(pos.max_rank())) &
                        pos.board_bb();
@@ -1423,7 +1487,7 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
     Bitboard drops = pos.drop_region(Them, IMMOBILE_PIECE);
     while (drops) {
       Square s = pop_lsb(drops);
-      if (pos.flip_enclosed_pieces() == REVERSI) {
+      if (Rules::flip_enclosed_pieces(pos) == REVERSI) {
         Bitboard b = attacks_bb(Them, QUEEN, s, ~pos.pieces(Us)) &
                      ~PseudoAttacks[Them][KING][s] & pos.pieces(Them);
         while (b)
@@ -1444,16 +1508,16 @@ template <Tracing T> template <Color Us> Score Evaluation<T>::variant() const {
 // based on the known attacking/defending status of the players. The final value
 // is derived by interpolation from the midgame and endgame values.
 
-template <Tracing T> Value Evaluation<T>::winnable(Score score) const {
+template <Tracing T, typename Rules> Value Evaluation<T, Rules>::winnable(Score score) const {
 
   // No initiative bonus for variants that do not require sufficient mating
   // material, e.g., extinction variants. This protects them from
   // misidentification as drawish.
   int complexity = 0;
   bool pawnsOnBothFlanks = true;
-  if (pos.extinction_value() == VALUE_NONE && !pos.captures_to_hand() &&
-      !pos.connect_n() && !pos.material_counting() &&
-      !(pos.flag_region(WHITE) || pos.flag_region(BLACK))) {
+  if (Rules::extinction_value(pos) == VALUE_NONE && !Rules::captures_to_hand(pos) &&
+      !Rules::connect_n(pos) && !pos.material_counting() &&
+      !(Rules::flag_region(pos, WHITE) || Rules::flag_region(pos, BLACK))) {
     int outflanking =
         !pos.count<KING>(WHITE) || !pos.count<KING>(BLACK)
             ? 0
@@ -1501,7 +1565,7 @@ template <Tracing T> Value Evaluation<T>::winnable(Score score) const {
 
   // If scale factor is not already specific, scale up/down via general
   // heuristics
-  if (sf == SCALE_FACTOR_NORMAL && !pos.captures_to_hand() &&
+  if (sf == SCALE_FACTOR_NORMAL && !Rules::captures_to_hand(pos) &&
       !pos.material_counting()) {
     if (pos.opposite_bishops()) {
       // For pure opposite colored bishops endgames use scale factor
@@ -1564,7 +1628,7 @@ template <Tracing T> Value Evaluation<T>::winnable(Score score) const {
 // various parts of the evaluation and returns the value of the position from
 // the point of view of the side to move.
 
-template <Tracing T> Value Evaluation<T>::value() {
+template <Tracing T, typename Rules> Value Evaluation<T, Rules>::value() {
 
   assert(!pos.checkers());
   assert(!pos.is_immediate_game_end());
@@ -1595,7 +1659,7 @@ template <Tracing T> Value Evaluation<T>::value() {
            lazyThreshold + pos.non_pawn_material() / 64;
   };
 
-  if (lazy_skip(LazyThreshold1) && Options["UCI_Variant"] == "chess")
+  if (Rules::lazy_eval(pos) && lazy_skip(Rules::lazyThreshold1))
     goto make_v;
 
   // Main evaluation begins here
@@ -1612,7 +1676,7 @@ template <Tracing T> Value Evaluation<T>::value() {
   }
 
   // Evaluate pieces in hand once attack tables are complete
-  if (pos.piece_drops() || pos.seirawan_gating())
+  if (Rules::piece_drops(pos) || Rules::seirawan_gating(pos))
     for (PieceSet ps = pos.piece_types(); ps;) {
       PieceType pt = pop_lsb(ps);
       score += hand<WHITE>(pt) - hand<BLACK>(pt);
@@ -1620,13 +1684,13 @@ template <Tracing T> Value Evaluation<T>::value() {
 
   score +=
       (mobility[WHITE] - mobility[BLACK]) *
-      (1 + pos.captures_to_hand() + pos.must_capture() + pos.check_counting());
+      (1 + Rules::captures_to_hand(pos) + Rules::must_capture(pos) + Rules::check_counting(pos));
 
   // More complex interactions that require fully populated attack bitboards
   score += king<WHITE>() - king<BLACK>() + passed<WHITE>() - passed<BLACK>() +
            variant<WHITE>() - variant<BLACK>();
 
-  if (lazy_skip(LazyThreshold2) && Options["UCI_Variant"] == "chess")
+  if (Rules::lazy_eval(pos) && lazy_skip(Rules::lazyThreshold2))
     goto make_v;
 
   score +=
@@ -1647,7 +1711,7 @@ make_v:
   v = (v / 16) * 16;
 
   // Side to move point of view
-  v = (pos.side_to_move() == WHITE ? v : -v) + 80 * pos.captures_to_hand();
+  v = (pos.side_to_move() == WHITE ? v : -v) + 80 * Rules::captures_to_hand(pos);
 
   return v;
 }
@@ -1683,16 +1747,57 @@ Value fix_FRC(const Position &pos) {
 
 } // namespace
 
+/// Eval::Cache::resize() sets the size of the cache in megabytes, 0 disables
+/// it. The cache is cleared.
+
+void Eval::Cache::resize(size_t mbSize) {
+
+  size_t count = mbSize * 1024 * 1024 / sizeof(Entry);
+  if (count != entryCount)
+  {
+      std_aligned_free(table);
+      table = count ? static_cast<Entry*>(std_aligned_alloc(64, count * sizeof(Entry))) : nullptr;
+      entryCount = table ? count : 0;
+      if (count && !table)
+          std::cerr << "Failed to allocate " << mbSize
+                    << "MB for the evaluation cache, it is disabled." << std::endl;
+  }
+
+  clear();
+}
+
+
+/// Eval::Cache::clear() empties the cache
+
+void Eval::Cache::clear() {
+
+  if (table)
+      std::memset(static_cast<void*>(table), 0, entryCount * sizeof(Entry));
+}
+
+
 /// evaluate() is the evaluator for the outer world. It returns a static
 /// evaluation of the position from the point of view of the side to move.
 
 Value Eval::evaluate(const Position &pos) {
 
+  STATS(StatsTimer timer(STATS_EVAL_TIME));
+
   Value v;
 
-  if (!Eval::useNNUE || !pos.nnue_applicable())
-    v = Evaluation<NO_TRACE>(pos).value();
-  else {
+  if (!Eval::useNNUE || !pos.nnue_applicable()) {
+    // The evaluation includes the trend of the thread, so the key does too
+    Thread *th = pos.this_thread();
+    Key key = pos.key() ^ make_key(uint64_t(th->trend));
+    th->evalCacheProbes.fetch_add(1, std::memory_order_relaxed);
+    if (th->evalCache.probe(key, v))
+      th->evalCacheHits.fetch_add(1, std::memory_order_relaxed);
+    else {
+      v = pos.variant()->janggiRules ? Evaluation<NO_TRACE, JanggiRules>(pos).value()
+                                     : Evaluation<NO_TRACE>(pos).value();
+      th->evalCache.save(key, v);
+    }
+  } else {
     // Scale and shift NNUE for compatibility with search and classical
     // evaluation
     auto adjusted_NNUE = [&]() {
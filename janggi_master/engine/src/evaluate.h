@@ -22,6 +22,7 @@
 #include <string>
 #include <optional>
 
+#include "misc.h"
 #include "types.h"
 
 #include "variant.h"
@@ -38,6 +39,46 @@ namespace Eval {
   extern bool useNNUE;
   extern std::string eval_file_loaded;
 
+  /// Eval::Cache keeps the classical evaluations of the positions a thread
+  /// evaluated recently, so that they outlive the TT entries of the positions
+  /// on small hash sizes. It is indexed like the TT and checks the low 32 bits
+  /// of the key. An entry is 8 bytes, so a cache line holds 8 of them.
+
+  class Cache {
+
+    struct Entry {
+      uint32_t key32;
+      int32_t value;
+    };
+
+  public:
+    Cache() = default;
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+    ~Cache() { std_aligned_free(table); }
+
+    void resize(size_t mbSize);
+    void clear();
+
+    bool probe(Key key, Value& v) const {
+      const Entry* e = entry(key);
+      return e && e->key32 == uint32_t(key) ? (v = Value(e->value), true) : false;
+    }
+
+    void save(Key key, Value v) {
+      if (Entry* e = entry(key))
+          *e = Entry{uint32_t(key), int32_t(v)};
+    }
+
+  private:
+    Entry* entry(Key key) const {
+      return entryCount ? &table[mul_hi64(key, entryCount)] : nullptr;
+    }
+
+    Entry* table = nullptr;
+    size_t entryCount = 0;
+  };
+
   // The default net name MUST follow the format nn-[SHA256 first 12 digits].nnue
   // for the build process (profile-build and fishtest) to work. Do not change the
   // name of the macro, as it is used in the Makefile.
@@ -0,0 +1,278 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gensfen.h"
+#include "misc.h"
+#include "movegen.h"
+#include "search.h"
+#include "thread.h"
+#include "tt.h"
+#include "uci.h"
+#include "variant.h"
+
+namespace Stockfish {
+
+namespace {
+
+  // A position of a game, written once the result of the game is known
+  struct Record {
+    std::string fen, move;
+    Value score;
+    int ply;
+    Color us;
+  };
+
+  // The games of all workers write to the output stream under a mutex,
+  // until 'written' reaches the count of the parameters.
+  struct Output {
+    const Variant* variant;
+    const Gensfen::Params* params;
+    std::ostream* out;
+    std::mutex mutex;
+    uint64_t written;
+    uint64_t nextReport;
+  };
+
+  // Converts a game result for the side to move to one for white
+  Value white_result(Value result, Color us) {
+    return result == VALUE_DRAW ? VALUE_DRAW
+         : (result > VALUE_DRAW) == (us == WHITE) ? VALUE_MATE : -VALUE_MATE;
+  }
+
+  // Swaps the horse and the elephant of each wing at random, giving the 16
+  // Janggi setups. Back ranks of other shapes are kept.
+  std::string random_setup(const std::string& fen, PRNG& rng) {
+
+    std::string board = fen.substr(0, fen.find(' '));
+    size_t first = board.find('/'), last = board.rfind('/');
+    if (first == std::string::npos)
+        return fen;
+
+    for (size_t start : { size_t(0), last + 1 })
+    {
+        size_t end = start ? board.size() : first;
+        if (end - start != 9)
+            continue;
+
+        for (size_t i : { start + 1, start + 6 })
+            if (   std::tolower(board[i]) != std::tolower(board[i + 1])
+                && std::string("nb").find(char(std::tolower(board[i]))) != std::string::npos
+                && std::string("nb").find(char(std::tolower(board[i + 1]))) != std::string::npos
+                && (rng.rand<uint64_t>() & 1))
+                std::swap(board[i], board[i + 1]);
+    }
+
+    return board + fen.substr(board.size());
+  }
+
+  // A Generator is a search thread outside of the thread pool. Its search()
+  // plays games until enough positions are written.
+  class Generator : public Thread {
+
+  public:
+    Generator(size_t n, Output& o)
+      : Thread(n), output(o), rng(o.params->seed + 0x9E3779B97F4A7C15ULL * n) {}
+    void search() override;
+
+  private:
+    Value play(std::vector<Record>& records);
+    bool write(const std::vector<Record>& records, Value result);
+
+    Output& output;
+    PRNG rng;
+  };
+
+  void Generator::search() {
+
+    std::vector<Record> records;
+
+    while (true)
+    {
+        records.clear();
+        clear();
+        Value result = play(records);
+        if (!write(records, result))
+            break;
+    }
+  }
+
+  // Plays a game and returns its result for white
+  Value Generator::play(std::vector<Record>& records) {
+
+    const Gensfen::Params& params = *output.params;
+    const Variant* v = output.variant;
+
+    std::string fen = params.openings.empty() ? v->startFen
+                     : params.openings[rng.rand<uint64_t>() % params.openings.size()];
+    if (v->janggiRules)
+        fen = random_setup(fen, rng);
+
+    // The random moves are played at distinct plies of the opening
+    std::vector<bool> randomPly(std::max(params.randomMaxPly, 0), false);
+    for (int i = 0; i < std::min(params.randomMoves, params.randomMaxPly); )
+    {
+        size_t ply = rng.rand<uint64_t>() % randomPly.size();
+        if (!randomPly[ply])
+            randomPly[ply] = true, ++i;
+    }
+
+    StateListPtr states(new std::deque<StateInfo>(1));
+    rootPos.set(v, fen, false, &states->back(), this);
+
+    for (int ply = 0; ; ++ply)
+    {
+        Color us = rootPos.side_to_move();
+        Value result;
+
+        if (rootPos.is_game_end(result))
+            return white_result(result, us);
+
+        rootMoves.clear();
+        for (const auto& m : MoveList<LEGAL>(rootPos))
+            rootMoves.emplace_back(m);
+
+        if (rootMoves.empty())
+        {
+            result = rootPos.checkers() ? rootPos.checkmate_value() : rootPos.stalemate_value();
+            return white_result(result, us);
+        }
+
+        if (ply >= params.maxPly)
+            return VALUE_DRAW;
+
+        Move m;
+        if (ply < int(randomPly.size()) && randomPly[ply])
+            m = rootMoves[rng.rand<uint64_t>() % rootMoves.size()].pv[0];
+        else
+        {
+            nodes = tbHits = nmpMinPly = bestMoveChanges = 0;
+            ttProbes = ttHits = 0;
+            evalCacheProbes = evalCacheHits = 0;
+            rootDepth = completedDepth = 0;
+            depthLimit = params.depth;
+            nodesLimit = params.nodes;
+
+            Thread::search();
+
+            const Search::RootMove& rm = rootMoves[0];
+            m = rm.pv[0];
+
+            if (std::abs(rm.score) >= params.evalLimit)
+                return white_result(rm.score, us);
+
+            if (ply >= params.writeMinPly && !rootPos.checkers())
+            {
+                Record r;
+                r.fen = rootPos.fen();
+                r.move = UCI::move(rootPos, m);
+                r.score = rm.score;
+                r.ply = rootPos.game_ply();
+                r.us = us;
+                records.push_back(r);
+            }
+        }
+
+        states->emplace_back();
+        rootPos.do_move(m, states->back());
+    }
+  }
+
+  // Writes the records of a game, returns false once enough positions are written
+  bool Generator::write(const std::vector<Record>& records, Value result) {
+
+    const Gensfen::Params& params = *output.params;
+    std::lock_guard<std::mutex> lk(output.mutex);
+    std::ostream& out = *output.out;
+
+    for (const Record& r : records)
+    {
+        if (output.written >= params.count)
+            break;
+
+        int res = result == VALUE_DRAW ? 0 : (result > VALUE_DRAW) == (r.us == WHITE) ? 1 : -1;
+        int16_t score = int16_t(std::clamp(int(r.score), -32767, 32767));
+
+        out << "fen " << r.fen
+            << "\nmove " << r.move
+            << "\nscore " << score
+            << "\nply " << r.ply
+            << "\nresult " << res
+            << "\ne\n";
+        ++output.written;
+    }
+
+    if (output.written >= output.nextReport)
+    {
+        sync_cout << "info string gensfen " << output.written << " positions" << sync_endl;
+        uint64_t step = std::max(params.count / 20, uint64_t(1));
+        output.nextReport = (output.written / step + 1) * step;
+    }
+
+    return output.written < params.count && !Threads.stop;
+  }
+
+} // namespace
+
+
+namespace Gensfen {
+
+uint64_t run(const Variant* v, const Params& params, std::ostream& out) {
+
+  Output output;
+  output.variant = v;
+  output.params = &params;
+  output.out = &out;
+  output.written = 0;
+  output.nextReport = std::max(params.count / 20, uint64_t(1));
+
+  // As for batch analysis, the generators share the global search state with
+  // the thread pool, so make sure the pool is idle and its limits do not apply.
+  Threads.main()->wait_for_search_finished();
+  Threads.stop = false;
+  Threads.increaseDepth = true;
+  Search::Limits = Search::LimitsType();
+  Search::Limits.multiPV = 1;
+  TT.new_search();
+
+  std::vector<std::unique_ptr<Generator>> pool;
+  for (size_t i = 0; i < std::max(params.workers, size_t(1)); ++i)
+      pool.emplace_back(new Generator(i + 1, output));
+
+  for (auto& g : pool)
+      g->start_searching();
+
+  for (auto& g : pool)
+      g->wait_for_search_finished();
+
+  out.flush();
+  return output.written;
+}
+
+} // namespace Gensfen
+
+} // namespace Stockfish
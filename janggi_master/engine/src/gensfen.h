@@ -0,0 +1,74 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GENSFEN_H_INCLUDED
+#define GENSFEN_H_INCLUDED
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace Stockfish {
+
+struct Variant;
+
+namespace Gensfen {
+
+/// Gensfen::Params are the settings of a training data run. A game starts
+/// from one of the openings, or the start position of the variant, with the
+/// horses and elephants of each wing swapped at random for the Janggi
+/// variants. 'randomMoves' of its first 'randomMaxPly' plies are random legal
+/// moves, the others the best move of a search limited by 'depth' and/or
+/// 'nodes'. The game ends by the rules, after 'maxPly' plies as a draw, or
+/// once the score reaches 'evalLimit'.
+
+struct Params {
+  uint64_t count = 1000000;
+  size_t workers = 1;
+  Depth depth = 8;
+  int64_t nodes = 0;
+  int randomMoves = 8;
+  int randomMaxPly = 24;
+  int writeMinPly = 16;
+  int maxPly = 400;
+  int evalLimit = 3000;
+  uint64_t seed = 1;
+  std::vector<std::string> openings;
+};
+
+/// Gensfen::run() plays games on independent search workers and writes the
+/// searched positions of each game to 'out' once the game is over, until
+/// 'count' positions are written. Positions in check are skipped. Returns
+/// the number of positions written.
+///
+/// The positions are written in the plain text format of the trainer tools,
+/// as "fen", "move", "score", "ply" and "result" lines closed by a line "e".
+/// The score is in internal units and the result 1, 0 or -1, both for the
+/// side to move. The tools convert this to their binary format, so their own
+/// packing of the variant is used.
+
+uint64_t run(const Variant* v, const Params& params, std::ostream& out);
+
+} // namespace Gensfen
+
+} // namespace Stockfish
+
+#endif // #ifndef GENSFEN_H_INCLUDED
@@ -0,0 +1,331 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include "mate.h"
+#include "movegen.h"
+#include "position.h"
+#include "uci.h"
+
+namespace Stockfish {
+
+namespace {
+
+  constexpr uint32_t PN_INFINITE = 1 << 28;
+
+  struct PnNode {
+    Move move;
+    uint32_t pn, dn;
+    uint32_t firstChild;
+    uint32_t childCount;
+    bool expanded;
+  };
+
+  // Generates the moves of the side to move that are searched: checks for
+  // the attacker and all legal moves, i.e. evasions, for the defender. The
+  // attacker's quiet moves are filtered by gives_check() rather than taken
+  // from generate<QUIET_CHECKS>, whose check squares miss the checks of
+  // horses, elephants and cannons, which are not symmetric.
+  ExtMove* generate_moves(const Position& pos, bool attacker, ExtMove* moveList) {
+
+    ExtMove* end = pos.checkers() ? generate<EVASIONS>(pos, moveList)
+                                  : generate<NON_EVASIONS>(pos, moveList);
+
+    for (ExtMove* cur = moveList; cur != end; )
+        if (pos.legal(*cur) && (!attacker || pos.gives_check(*cur)))
+            ++cur;
+        else
+            *cur = (--end)->move;
+
+    return end;
+  }
+
+  // A ProofTree decides whether the defender, to move in the root position,
+  // is mated within a given number of plies. The tree is kept explicitly and
+  // grown at its most proving node until the root is proven or disproven.
+  class ProofTree {
+
+  public:
+    ProofTree(Position& p, uint64_t limit) : pos(p), maxNodes(limit) {}
+
+    Mate::Status prove(int plies);
+    Mate::Node solution(Move rootMove) const { return solution(0, 0, rootMove); }
+    uint64_t size() const { return nodes.size(); }
+
+  private:
+    void expand(uint32_t idx, int ply);
+    void update(uint32_t idx, bool attacker);
+    int height(uint32_t idx, int ply) const;
+    Mate::Node solution(uint32_t idx, int ply, Move m) const;
+
+    void set(uint32_t idx, bool proven) {
+      nodes[idx].pn = proven ? 0 : PN_INFINITE;
+      nodes[idx].dn = proven ? PN_INFINITE : 0;
+    }
+
+    Position& pos;
+    uint64_t maxNodes;
+    int rootPlies;
+    std::vector<PnNode> nodes;
+    std::vector<StateInfo> states;
+  };
+
+  Mate::Status ProofTree::prove(int plies) {
+
+    rootPlies = plies;
+    states.resize(plies + 1);
+    nodes.clear();
+    nodes.push_back({MOVE_NONE, 1, 1, 0, 0, false});
+
+    std::vector<uint32_t> path;
+
+    while (nodes[0].pn && nodes[0].dn)
+    {
+        if (nodes.size() >= maxNodes)
+            return Mate::UNKNOWN;
+
+        // Walk down to the most proving node. The attacker is to move at odd plies.
+        uint32_t idx = 0;
+        int ply = 0;
+        while (nodes[idx].expanded)
+        {
+            const PnNode& n = nodes[idx];
+            uint32_t best = n.firstChild;
+            for (uint32_t c = n.firstChild + 1; c < n.firstChild + n.childCount; ++c)
+                if ((ply & 1) ? nodes[c].pn < nodes[best].pn : nodes[c].dn < nodes[best].dn)
+                    best = c;
+
+            pos.do_move(nodes[best].move, states[ply]);
+            path.push_back(idx);
+            idx = best;
+            ++ply;
+        }
+
+        expand(idx, ply);
+
+        // Back up the proof and disproof numbers to the root
+        while (!path.empty())
+        {
+            pos.undo_move(nodes[idx].move);
+            idx = path.back();
+            path.pop_back();
+            update(idx, --ply & 1);
+        }
+    }
+
+    return nodes[0].pn == 0 ? Mate::PROVEN : Mate::DISPROVEN;
+  }
+
+  void ProofTree::expand(uint32_t idx, int ply) {
+
+    bool attacker = ply & 1;
+    Value result;
+
+    nodes[idx].expanded = true;
+
+    // The key move has already been made, so the distance from the root of
+    // the search is one more than the ply of the tree.
+    if (pos.is_game_end(result, ply + 1))
+    {
+        set(idx, attacker ? result > VALUE_DRAW : result < VALUE_DRAW);
+        return;
+    }
+
+    ExtMove moveList[MAX_MOVES];
+    ExtMove* end = generate_moves(pos, attacker, moveList);
+
+    if (end == moveList)
+    {
+        if (attacker)
+            set(idx, false);
+        else
+        {
+            result = pos.checkers() ? pos.checkmate_value(ply + 1) : pos.stalemate_value(ply + 1);
+            set(idx, result < VALUE_DRAW);
+        }
+        return;
+    }
+
+    // The defender survives if the attacker has no moves left
+    if (ply == rootPlies)
+    {
+        set(idx, false);
+        return;
+    }
+
+    nodes[idx].firstChild = uint32_t(nodes.size());
+    nodes[idx].childCount = uint32_t(end - moveList);
+    for (ExtMove* m = moveList; m != end; ++m)
+        nodes.push_back({m->move, 1, 1, 0, 0, false});
+
+    update(idx, attacker);
+  }
+
+  // An attacker node is proven as soon as one child is, a defender node
+  // only when all children are.
+  void ProofTree::update(uint32_t idx, bool attacker) {
+
+    PnNode& n = nodes[idx];
+    uint32_t minimum = PN_INFINITE, sum = 0;
+
+    for (uint32_t c = n.firstChild; c < n.firstChild + n.childCount; ++c)
+    {
+        uint32_t summed = attacker ? nodes[c].dn : nodes[c].pn;
+        minimum = std::min(minimum, attacker ? nodes[c].pn : nodes[c].dn);
+        sum = std::min(sum + summed, PN_INFINITE);
+    }
+
+    n.pn = attacker ? minimum : sum;
+    n.dn = attacker ? sum : minimum;
+  }
+
+  // Number of plies to mate below a proven node
+  int ProofTree::height(uint32_t idx, int ply) const {
+
+    const PnNode& n = nodes[idx];
+    if (!n.childCount)
+        return 0;
+
+    int h = (ply & 1) ? MAX_PLY : 0;
+    for (uint32_t c = n.firstChild; c < n.firstChild + n.childCount; ++c)
+        if (nodes[c].pn == 0)
+            h = (ply & 1) ? std::min(h, height(c, ply + 1)) : std::max(h, height(c, ply + 1));
+
+    return h + 1;
+  }
+
+  Mate::Node ProofTree::solution(uint32_t idx, int ply, Move m) const {
+
+    const PnNode& n = nodes[idx];
+    Mate::Node node{m, height(idx, ply) / 2 + 1, {}};
+
+    if (ply & 1)
+    {
+        uint32_t best = 0;
+        int bestHeight = MAX_PLY;
+        for (uint32_t c = n.firstChild; c < n.firstChild + n.childCount; ++c)
+            if (nodes[c].pn == 0 && height(c, ply + 1) < bestHeight)
+                best = c, bestHeight = height(c, ply + 1);
+
+        if (best)
+            node.children.push_back(solution(best, ply + 1, nodes[best].move));
+    }
+    else
+        for (uint32_t c = n.firstChild; c < n.firstChild + n.childCount; ++c)
+            node.children.push_back(solution(c, ply + 1, nodes[c].move));
+
+    return node;
+  }
+
+  void append_json(const Position& pos, const Mate::Node& node, std::string& out) {
+
+    out += "{\"move\":\"" + UCI::move(pos, node.move)
+         + "\",\"mateIn\":" + std::to_string(node.mateIn) + ",\"children\":[";
+
+    for (size_t i = 0; i < node.children.size(); ++i)
+    {
+        if (i)
+            out += ",";
+        append_json(pos, node.children[i], out);
+    }
+
+    out += "]}";
+  }
+
+} // namespace
+
+
+namespace Mate {
+
+Result search(Position& pos, int maxMateIn, uint64_t maxNodes) {
+
+  Result result;
+  StateInfo st;
+
+  ExtMove moveList[MAX_MOVES];
+  ExtMove* end = generate_moves(pos, true, moveList);
+
+  // Every checking move is a candidate key move. Deepening the proof one move
+  // at a time finds the fastest mate after each of them.
+  for (ExtMove* m = moveList; m != end && result.complete; ++m)
+  {
+      pos.do_move(*m, st);
+
+      for (int k = 1; k <= maxMateIn; ++k)
+      {
+          // A tree can end a few expansions past its limit, so the budget
+          // may already be used up by the previous ones.
+          if (result.nodes >= maxNodes)
+          {
+              result.complete = false;
+              break;
+          }
+
+          ProofTree tree(pos, maxNodes - result.nodes);
+          Status s = tree.prove(2 * k - 2);
+          result.nodes += tree.size();
+
+          if (s == PROVEN)
+          {
+              result.keyMoves.push_back(tree.solution(*m));
+              break;
+          }
+          if (s == UNKNOWN)
+          {
+              result.complete = false;
+              break;
+          }
+      }
+
+      pos.undo_move(*m);
+  }
+
+  std::stable_sort(result.keyMoves.begin(), result.keyMoves.end(),
+                   [](const Node& a, const Node& b) { return a.mateIn < b.mateIn; });
+
+  result.status =  !result.keyMoves.empty() ? PROVEN
+                 : !result.complete         ? UNKNOWN
+                                            : DISPROVEN;
+  result.mateIn = result.keyMoves.empty() ? 0 : result.keyMoves[0].mateIn;
+  return result;
+}
+
+std::string to_json(const Position& pos, const Result& result) {
+
+  static const char* StatusNames[] = { "unknown", "proven", "disproven" };
+
+  std::string out = std::string("{\"status\":\"") + StatusNames[result.status]
+                  + "\",\"mateIn\":" + std::to_string(result.mateIn)
+                  + ",\"nodes\":" + std::to_string(result.nodes)
+                  + ",\"complete\":" + (result.complete ? "true" : "false")
+                  + ",\"keyMoves\":[";
+
+  for (size_t i = 0; i < result.keyMoves.size(); ++i)
+  {
+      if (i)
+          out += ",";
+      append_json(pos, result.keyMoves[i], out);
+  }
+
+  return out + "]}";
+}
+
+} // namespace Mate
+
+} // namespace Stockfish
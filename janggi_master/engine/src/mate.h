@@ -0,0 +1,72 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MATE_H_INCLUDED
+#define MATE_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace Stockfish {
+
+class Position;
+
+namespace Mate {
+
+enum Status { UNKNOWN, PROVEN, DISPROVEN };
+
+/// Mate::Node is a move of the solution tree together with the number of
+/// moves of the mating side until mate, counting the move itself if it is
+/// one of them. Below a key move the tree lists every legal defence and, for
+/// each of them, the move that mates fastest.
+
+struct Node {
+  Move move;
+  int mateIn;
+  std::vector<Node> children;
+};
+
+/// Mate::Result holds every key move that mates within the limit, fastest
+/// first. A mate is only proven if every move of the mating side gives check.
+/// 'complete' is false if the node limit was hit before all checking moves
+/// were decided, in which case there may be more key moves.
+
+struct Result {
+  Status status = UNKNOWN;
+  int mateIn = 0;
+  uint64_t nodes = 0;
+  bool complete = true;
+  std::vector<Node> keyMoves;
+};
+
+/// Mate::search() is a proof-number search for a checking mate of the side to
+/// move in at most 'maxMateIn' moves. The attacker only plays checks and the
+/// defender evasions. 'maxNodes' bounds the total size of the proof trees.
+
+Result search(Position& pos, int maxMateIn, uint64_t maxNodes);
+
+std::string to_json(const Position& pos, const Result& result);
+
+} // namespace Mate
+
+} // namespace Stockfish
+
+#endif // #ifndef MATE_H_INCLUDED
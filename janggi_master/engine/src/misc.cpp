@@ -39,6 +39,7 @@ typedef bool(*fun3_t)(HANDLE, CONST GROUP_AFFINITY*, PGROUP_AFFINITY);
 }
 #endif
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -51,6 +52,10 @@ typedef bool(*fun3_t)(HANDLE, CONST GROUP_AFFINITY*, PGROUP_AFFINITY);
 #include <sys/mman.h>
 #endif
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #if defined(__APPLE__) || defined(__ANDROID__) || defined(__OpenBSD__) || (defined(__GLIBCXX__) && !defined(_GLIBCXX_HAVE_ALIGNED_ALLOC) && !defined(_WIN32)) || defined(__e2k__)
 #define POSIXALIGNEDALLOC
 #include <stdlib.h>
@@ -154,7 +159,9 @@ string engine_info(bool to_uci, bool to_xboard) {
       ss << setw(2) << day << setw(2) << (1 + months.find(month) / 4) << year.substr(2);
   }
 
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+  ss << " JG";
+#elif defined(LARGEBOARDS)
   ss << " LB";
 #endif
 
@@ -265,6 +272,9 @@ std::string compiler_info() {
   #if defined(USE_NEON)
     compiler += " NEON";
   #endif
+  #if defined(SEARCH_STATS)
+    compiler += " SEARCH_STATS";
+  #endif
 
   #if !defined(NDEBUG)
     compiler += " DEBUG";
@@ -283,21 +293,63 @@ std::string compiler_info() {
 
 
 /// Debug functions used mainly to collect run-time statistics
-static std::atomic<int64_t> hits[2], means[2];
+static std::atomic<int64_t> hits[DbgSlots][2], means[DbgSlots][2];
+
+void dbg_hit_on(bool b, int slot) { ++hits[slot][0]; if (b) ++hits[slot][1]; }
+void dbg_hit_on(bool c, bool b, int slot) { if (c) dbg_hit_on(b, slot); }
+void dbg_mean_of(int64_t v, int slot) { ++means[slot][0]; means[slot][1] += v; }
+
+std::pair<int64_t, int64_t> dbg_hits(int slot) { return { hits[slot][0], hits[slot][1] }; }
+std::pair<int64_t, int64_t> dbg_means(int slot) { return { means[slot][0], means[slot][1] }; }
 
-void dbg_hit_on(bool b) { ++hits[0]; if (b) ++hits[1]; }
-void dbg_hit_on(bool c, bool b) { if (c) dbg_hit_on(b); }
-void dbg_mean_of(int v) { ++means[0]; means[1] += v; }
+void dbg_clear() {
+
+  for (int i = 0; i < DbgSlots; ++i)
+      hits[i][0] = hits[i][1] = means[i][0] = means[i][1] = 0;
+}
 
 void dbg_print() {
 
-  if (hits[0])
-      cerr << "Total " << hits[0] << " Hits " << hits[1]
-           << " hit rate (%) " << 100 * hits[1] / hits[0] << endl;
+  // The StatsSlot counters are printed by the 'stats' command
+  for (int i = 0; i < DbgSlots; ++i)
+      if (hits[i][0] && (i == 0 || i >= STATS_SLOT_NB))
+          cerr << "Hit #" << i
+               << ": Total " << hits[i][0] << " Hits " << hits[i][1]
+               << " hit rate (%) " << 100 * hits[i][1] / hits[i][0] << endl;
+
+  for (int i = 0; i < DbgSlots; ++i)
+      if (means[i][0] && (i == 0 || i >= STATS_SLOT_NB))
+          cerr << "Mean #" << i
+               << ": Total " << means[i][0] << " Mean "
+               << (double)means[i][1] / means[i][0] << endl;
+}
+
+
+std::ostream& operator<<(std::ostream& os, const SearchStats& s) {
+
+  auto permille = [](uint64_t part, uint64_t total) { return total ? part * 1000 / total : 0; };
+  const int64_t threadTime = s.time * int64_t(std::max<uint64_t>(1, s.threads));
+  uint64_t cutoffs = 0;
+  for (uint64_t c : s.cutoffs)
+      cutoffs += c;
+
+  os << "nodes " << s.nodes << " qnodes " << s.qnodes
+     << "\ntt probes " << s.ttProbes << " hits " << s.ttHits
+     << " (" << permille(s.ttHits, s.ttProbes) << " permille) collisions " << s.ttCollisions
+     << "\ncutoffs " << cutoffs << " by move";
+  for (int i = 0; i < SearchStats::CutoffSlots; ++i)
+      os << " " << (i + 1 < SearchStats::CutoffSlots ? std::to_string(i + 1) : std::to_string(i + 1) + "+")
+         << ":" << permille(s.cutoffs[i], cutoffs);
+  os << " (permille)"
+     << "\nnull move tries " << s.nullMoveTries << " cutoffs " << s.nullMoveCutoffs
+     << "\nlmr searches " << s.lmrSearches << " researches " << s.lmrResearches
+     << "\neval calls " << s.evalCalls << " cache probes " << s.evalCacheProbes
+     << " hits " << s.evalCacheHits << " (" << permille(s.evalCacheHits, s.evalCacheProbes) << " permille)"
+     << "\ntime " << s.time / 1000000 << " ms, thread time movegen " << s.movegenTime / 1000000
+     << " ms eval " << s.evalTime / 1000000
+     << " ms search " << std::max<int64_t>(0, threadTime - s.movegenTime - s.evalTime) / 1000000 << " ms";
 
-  if (means[0])
-      cerr << "Total " << means[0] << " Mean "
-           << (double)means[1] / means[0] << endl;
+  return os;
 }
 
 
@@ -596,6 +648,77 @@ void bindThisThread(size_t idx) {
 
 } // namespace WinProcGroup
 
+
+namespace CpuCluster {
+
+#if !defined(__linux__)
+
+void bindThisThread(Kind) {}
+
+#else
+
+namespace {
+
+  struct Clusters {
+    cpu_set_t all, big, little;
+  };
+
+  // Reads the maximum frequency of each core from sysfs. Cores faster than the
+  // slowest ones form the BIG cluster. If all cores are alike, both clusters
+  // contain every core.
+  Clusters read_clusters() {
+
+    Clusters c;
+    CPU_ZERO(&c.all);
+    CPU_ZERO(&c.big);
+    CPU_ZERO(&c.little);
+
+    std::vector<long> freq;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq");
+        long khz = 0;
+        if (!(f >> khz))
+            break;
+        freq.push_back(khz);
+    }
+
+    if (freq.empty())
+    {
+        sched_getaffinity(0, sizeof(cpu_set_t), &c.all);
+        c.big = c.little = c.all;
+        return c;
+    }
+
+    const long slowest = *std::min_element(freq.begin(), freq.end());
+    const long fastest = *std::max_element(freq.begin(), freq.end());
+    for (size_t cpu = 0; cpu < freq.size(); ++cpu)
+    {
+        CPU_SET(cpu, &c.all);
+        if (freq[cpu] > slowest || fastest == slowest)
+            CPU_SET(cpu, &c.big);
+        if (freq[cpu] == slowest)
+            CPU_SET(cpu, &c.little);
+    }
+    return c;
+  }
+
+} // namespace
+
+void bindThisThread(Kind kind) {
+
+  static const Clusters clusters = read_clusters();
+
+  const cpu_set_t& set =  kind == BIG    ? clusters.big
+                        : kind == LITTLE ? clusters.little
+                                         : clusters.all;
+  sched_setaffinity(0, sizeof(cpu_set_t), &set);
+}
+
+#endif
+
+} // namespace CpuCluster
+
 #ifdef _WIN32
 #include <direct.h>
 #define GETCWD _getcwd
@@ -23,6 +23,7 @@
 #include <chrono>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <cstdint>
 
@@ -39,11 +40,71 @@ void std_aligned_free(void* ptr);
 void* aligned_large_pages_alloc(size_t size); // memory aligned by page size, min alignment: 4096 bytes
 void aligned_large_pages_free(void* mem); // nop if mem == nullptr
 
-void dbg_hit_on(bool b);
-void dbg_hit_on(bool c, bool b);
-void dbg_mean_of(int v);
+/// Debug counters. The slot selects one of several independent counters, slot 0
+/// is for ad hoc debugging and the StatsSlot ones are filled by SEARCH_STATS
+/// builds. dbg_hits() returns the total and the hits of a slot, dbg_means()
+/// the count and the sum of its values.
+
+constexpr int DbgSlots = 32;
+
+void dbg_hit_on(bool b, int slot = 0);
+void dbg_hit_on(bool c, bool b, int slot = 0);
+void dbg_mean_of(int64_t v, int slot = 0);
+std::pair<int64_t, int64_t> dbg_hits(int slot);
+std::pair<int64_t, int64_t> dbg_means(int slot);
+void dbg_clear();
 void dbg_print();
 
+/// SearchStats holds the counters of a search, read from the dbg_* slots by
+/// ThreadPool::search_stats(). The counters are cleared when a search starts.
+/// Without SEARCH_STATS the STATS() statements compile to nothing. Times are
+/// in nanoseconds; move generation and evaluation times are summed over the
+/// threads, so with several threads they can exceed the wall time.
+
+struct SearchStats {
+
+  static constexpr int CutoffSlots = 8; // Beta cutoffs of search() by move count, the last slot counts the rest
+
+  uint64_t nodes, qnodes, ttProbes, ttHits, ttCollisions, evalCalls;
+  uint64_t evalCacheProbes, evalCacheHits;
+  uint64_t cutoffs[CutoffSlots];
+  uint64_t nullMoveTries, nullMoveCutoffs;
+  uint64_t lmrSearches, lmrResearches;
+  uint64_t threads;
+  int64_t time, movegenTime, evalTime;
+};
+
+enum StatsSlot {
+  STATS_QNODES = 1,    // hits: qsearch() nodes, hit if PV
+  STATS_TT_COLLISION,  // hits: TT misses, hit if the entry held another position
+  STATS_NULL_MOVE,     // hits: null move searches, hit on a cutoff
+  STATS_LMR,           // hits: reduced searches, hit on a re-search
+  STATS_TIME,          // means: wall time of the main thread
+  STATS_MOVEGEN_TIME,  // means: time of each move generation
+  STATS_EVAL_TIME,     // means: time of each evaluation
+  STATS_CUTOFF,        // means: move count of the beta cutoffs, one slot per count
+  STATS_SLOT_NB = STATS_CUTOFF + SearchStats::CutoffSlots
+};
+
+static_assert(STATS_SLOT_NB <= DbgSlots, "Not enough dbg slots");
+
+/// StatsTimer passes the time of its scope to dbg_mean_of()
+struct StatsTimer {
+  explicit StatsTimer(int s) : slot(s), start(std::chrono::steady_clock::now()) {}
+ ~StatsTimer() { dbg_mean_of(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), slot); }
+
+  int slot;
+  std::chrono::steady_clock::time_point start;
+};
+
+std::ostream& operator<<(std::ostream& os, const SearchStats& s);
+
+#ifdef SEARCH_STATS
+#define STATS(x) x
+#else
+#define STATS(x)
+#endif
+
 typedef std::chrono::milliseconds::rep TimePoint; // A value in milliseconds
 static_assert(sizeof(TimePoint) == sizeof(int64_t), "TimePoint should be 64 bits");
 inline TimePoint now() {
@@ -188,6 +249,15 @@ namespace WinProcGroup {
   void bindThisThread(size_t idx);
 }
 
+/// Under Linux and Android, CpuCluster::bindThisThread() restricts the current
+/// thread to the fast (BIG) or the slowest (LITTLE) cores of a big.LITTLE CPU,
+/// telling them apart by their maximum frequency. ALL allows every core again.
+
+namespace CpuCluster {
+  enum Kind { ALL, BIG, LITTLE };
+  void bindThisThread(Kind kind);
+}
+
 namespace CommandLine {
   void init(int argc, char* argv[]);
 
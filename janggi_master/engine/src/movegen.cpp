@@ -297,8 +297,10 @@ namespace {
     {
         Square from = pop_lsb(bb);
 
-        Bitboard attacks = pos.attacks_from(Us, Pt, from);
-        Bitboard quiets = pos.moves_from(Us, Pt, from);
+        // Janggi pieces read their attacks from the attack maps, and most of
+        // them move the way they capture
+        Bitboard attacks = pos.variant()->attackMaps ? pos.piece_attacks(from) : pos.attacks_from(Us, Pt, from);
+        Bitboard quiets = pos.variant()->attackMaps && (SymmetricMoveTypes & Pt) ? attacks : pos.moves_from(Us, Pt, from);
         Bitboard b = (  (attacks & pos.pieces())
                        | (quiets & ~pos.pieces()));
         Bitboard b1 = b & target;
@@ -455,8 +457,10 @@ namespace {
     // King moves
     if (pos.count<KING>(Us) && (!Checks || pos.blockers_for_king(~Us) & ksq))
     {
-        Bitboard b = (  (pos.attacks_from(Us, KING, ksq) & pos.pieces())
-                      | (pos.moves_from(Us, KING, ksq) & ~pos.pieces())) & (Type == EVASIONS ? ~pos.pieces(Us) : target);
+        Bitboard b = pos.variant()->attackMaps && (SymmetricMoveTypes & pos.king_type())
+                    ? pos.piece_attacks(ksq) & (Type == EVASIONS ? ~pos.pieces(Us) : target)
+                    : (  (pos.attacks_from(Us, KING, ksq) & pos.pieces())
+                       | (pos.moves_from(Us, KING, ksq) & ~pos.pieces())) & (Type == EVASIONS ? ~pos.pieces(Us) : target);
         while (b)
             moveList = make_move_and_gating<NORMAL>(pos, moveList, Us, ksq, pop_lsb(b));
 
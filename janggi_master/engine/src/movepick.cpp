@@ -19,15 +19,40 @@
 #include <cassert>
 
 #include "movepick.h"
+#include "thread.h"
 
 namespace Stockfish {
 
 // Since continuation history grows quadratically with the number of piece types,
 // we need to reserve a limited number of slots and map piece types to these slots
 // in order to reduce memory consumption to a reasonable level.
+#ifdef JANGGI_ONLY
+namespace {
+
+  // The seven Janggi piece types fit into the history slots without collisions
+  int janggi_slot(PieceType pt) {
+    switch (pt)
+    {
+    case ROOK:            return 1;
+    case HORSE:           return 2;
+    case JANGGI_ELEPHANT: return 3;
+    case WAZIR:           return 4;
+    case JANGGI_CANNON:   return 5;
+    case SOLDIER:         return 6;
+    default:              return PIECE_SLOTS - 1;
+    }
+  }
+
+} // namespace
+
+int history_slot(Piece pc) {
+    return pc == NO_PIECE ? 0 : janggi_slot(type_of(pc)) + color_of(pc) * PIECE_SLOTS;
+}
+#else
 int history_slot(Piece pc) {
     return pc == NO_PIECE ? 0 : (type_of(pc) == KING ? PIECE_SLOTS - 1 : type_of(pc) % (PIECE_SLOTS - 1)) + color_of(pc) * PIECE_SLOTS;
 }
+#endif
 
 namespace {
 
@@ -53,6 +78,14 @@ namespace {
         }
   }
 
+  // generate_moves() calls generate(), timing it for the search statistics
+  template<GenType Type>
+  ExtMove* generate_moves(const Position& pos, ExtMove* moveList) {
+
+    STATS(StatsTimer timer(STATS_MOVEGEN_TIME));
+    return generate<Type>(pos, moveList);
+  }
+
 } // namespace
 
 
@@ -111,7 +144,7 @@ void MovePicker::score() {
       if constexpr (Type == CAPTURES)
           m.value =  int(PieceValue[MG][pos.piece_on(to_sq(m))]) * 6
                    + (*gateHistory)[pos.side_to_move()][gating_square(m)]
-                   + (*captureHistory)[pos.moved_piece(m)][to_sq(m)][type_of(pos.piece_on(to_sq(m)))];
+                   + (*captureHistory)[history_index(pos.moved_piece(m))][to_sq(m)][history_index(type_of(pos.piece_on(to_sq(m))))];
 
       else if constexpr (Type == QUIETS)
           m.value =      (*mainHistory)[pos.side_to_move()][from_to(m)]
@@ -172,7 +205,7 @@ top:
   case PROBCUT_INIT:
   case QCAPTURE_INIT:
       cur = endBadCaptures = moves;
-      endMoves = generate<CAPTURES>(pos, cur);
+      endMoves = generate_moves<CAPTURES>(pos, cur);
 
       score<CAPTURES>();
       ++stage;
@@ -209,7 +242,7 @@ top:
       if (!skipQuiets && !(pos.must_capture() && pos.has_capture()))
       {
           cur = endBadCaptures;
-          endMoves = generate<QUIETS>(pos, cur);
+          endMoves = generate_moves<QUIETS>(pos, cur);
 
           score<QUIETS>();
           partial_insertion_sort(cur, endMoves, -3000 * depth);
@@ -237,7 +270,7 @@ top:
 
   case EVASION_INIT:
       cur = moves;
-      endMoves = generate<EVASIONS>(pos, cur);
+      endMoves = generate_moves<EVASIONS>(pos, cur);
 
       score<EVASIONS>();
       ++stage;
@@ -263,7 +296,7 @@ top:
 
   case QCHECK_INIT:
       cur = moves;
-      endMoves = generate<QUIET_CHECKS>(pos, cur);
+      endMoves = generate_moves<QUIET_CHECKS>(pos, cur);
 
       ++stage;
       [[fallthrough]];
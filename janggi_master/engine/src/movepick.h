@@ -96,12 +96,23 @@ typedef Stats<int16_t, 13365, COLOR_NB, SQUARE_NB> GateHistory;
 constexpr int MAX_LPH = 4;
 typedef Stats<int16_t, 10692, MAX_LPH, int(SQUARE_NB + 1) * int(1 << SQUARE_BITS)> LowPlyHistory;
 
+/// Janggi-only builds address the piece dimensions of CounterMoveHistory and
+/// CapturePieceToHistory by history slot instead of by piece, which shrinks
+/// the capture history from ~2 MB to ~20 KB per thread.
+#ifdef JANGGI_ONLY
+constexpr int HISTORY_PIECE_NB = 2 * PIECE_SLOTS;
+constexpr int HISTORY_PIECE_TYPE_NB = PIECE_SLOTS;
+#else
+constexpr int HISTORY_PIECE_NB = PIECE_NB;
+constexpr int HISTORY_PIECE_TYPE_NB = PIECE_TYPE_NB;
+#endif
+
 /// CounterMoveHistory stores counter moves indexed by [piece][to] of the previous
 /// move, see www.chessprogramming.org/Countermove_Heuristic
-typedef Stats<Move, NOT_USED, PIECE_NB, SQUARE_NB> CounterMoveHistory;
+typedef Stats<Move, NOT_USED, HISTORY_PIECE_NB, SQUARE_NB> CounterMoveHistory;
 
 /// CapturePieceToHistory is addressed by a move's [piece][to][captured piece type]
-typedef Stats<int16_t, 10692, PIECE_NB, SQUARE_NB, PIECE_TYPE_NB> CapturePieceToHistory;
+typedef Stats<int16_t, 10692, HISTORY_PIECE_NB, SQUARE_NB, HISTORY_PIECE_TYPE_NB> CapturePieceToHistory;
 
 /// PieceToHistory is like ButterflyHistory but is addressed by a move's [piece][to]
 typedef Stats<int16_t, 29952, 2 * PIECE_SLOTS, SQUARE_NB> PieceToHistory;
@@ -113,6 +124,16 @@ typedef Stats<PieceToHistory, NOT_USED, 2 * PIECE_SLOTS, SQUARE_NB> Continuation
 
 int history_slot(Piece pc);
 
+/// history_index() maps a piece or piece type to its index in the
+/// CounterMoveHistory and CapturePieceToHistory tables
+#ifdef JANGGI_ONLY
+inline int history_index(Piece pc) { return history_slot(pc); }
+inline int history_index(PieceType pt) { return history_slot(make_piece(WHITE, pt)); }
+#else
+constexpr int history_index(Piece pc) { return pc; }
+constexpr int history_index(PieceType pt) { return pt; }
+#endif
+
 /// MovePicker class is used to pick one pseudo-legal move at a time from the
 /// current position. The most important method is next_move(), which returns a
 /// new pseudo-legal move each time it is called, until there are no moves left,
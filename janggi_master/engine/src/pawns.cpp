@@ -224,7 +224,7 @@ Entry* probe(const Position& pos) {
   Key key = pos.pawn_key();
   Entry* e = pos.this_thread()->pawnsTable[key];
 
-  if (e->key == key && !pos.pieces(SHOGI_PAWN))
+  if (e->key == key && !pos.pieces(SHOGI_PAWN, SOLDIER))
       return e;
 
   e->key = key;
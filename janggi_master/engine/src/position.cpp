@@ -143,6 +143,13 @@ Key cuckoo[8192];
 Move cuckooMove[8192];
 #endif
 
+namespace {
+
+// Squares from which a Janggi horse or elephant has a leg on a square
+Bitboard LegSquares[SQUARE_NB];
+
+} // namespace
+
 /// Position::init() initializes at startup the various arrays used to compute
 /// hash keys
 
@@ -179,6 +186,13 @@ void Position::init() {
   for (int i = NO_EG_EVAL; i < EG_EVAL_NB; ++i)
     Zobrist::endgame[i] = rng.rand<Key>();
 
+  for (Square s1 = SQ_A1; s1 <= SQ_MAX; ++s1)
+    for (Square s2 = SQ_A1; s2 <= SQ_MAX; ++s2) {
+      int df = distance<File>(s1, s2), dr = distance<Rank>(s1, s2);
+      if (df + dr == 1 || (df + dr == 3 && df && dr))
+        LegSquares[s1] |= s2;
+    }
+
   // Prepare the cuckoo tables
   std::memset(cuckoo, 0, sizeof(cuckoo));
   std::memset(cuckooMove, 0, sizeof(cuckooMove));
@@ -210,7 +224,9 @@ void Position::init() {
             count++;
           }
     }
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+  assert(count == 2140);
+#elif defined(LARGEBOARDS)
   assert(count == 9344);
 #else
   assert(count == 3668);
@@ -547,6 +563,7 @@ Position &Position::set(const Variant *v, const string &fenStr, bool isChess960,
   tsumeMode = Options["TsumeMode"];
   thisThread = th;
   set_state(st);
+  attackMapStale = AllSquares;
 
   assert(pos_is_ok());
 
@@ -1021,10 +1038,11 @@ Bitboard Position::attackers_to(Square s, Bitboard occupied, Color c,
       diags |= attacks_bb(~c, FERS, s, occupied) & pieces(c, KING);
     diags |= attacks_bb(~c, FERS, s, occupied) & pieces(c, WAZIR);
     diags |= attacks_bb(~c, PAWN, s, occupied) & pieces(c, SOLDIER);
-    // diags |= rider_attacks_bb<RIDER_BISHOP>(s, occupied) & pieces(c, ROOK);
-    // diags |= rider_attacks_bb<RIDER_CANNON_DIAG>(s, occupied) &
-    //          rider_attacks_bb<RIDER_CANNON_DIAG>(s, occupied &
-    //          ~janggiCannons) & pieces(c, JANGGI_CANNON);
+    diags |= palace_diagonal_attacks(ROOK, s, occupied, janggiCannons) &
+             pieces(c, ROOK);
+    diags |= palace_diagonal_attacks(JANGGI_CANNON, s, occupied,
+                                     janggiCannons) &
+             pieces(c, JANGGI_CANNON);
     b |= diags & diagonal_lines();
   }
 
@@ -1530,29 +1548,16 @@ bool Position::gives_check(Move m) const {
   // Is there a check by special diagonal moves?
   if (more_than_one(diagonal_lines() & (to | square<KING>(~sideToMove)))) {
     PieceType pt = type_of(moved_piece(m));
-    PieceType diagType = pt == WAZIR ? FERS
-                         : pt == SOLDIER
-                             ? PAWN
-                             // : pt == ROOK    ? BISHOP  <-- Causes crash due
-                             // to uninitialized Bishop magics
-                             : NO_PIECE_TYPE;
+    PieceType diagType = pt == WAZIR     ? FERS
+                         : pt == SOLDIER ? PAWN
+                                         : NO_PIECE_TYPE;
     if (diagType && (attacks_bb(sideToMove, diagType, to, occupied) &
                      square<KING>(~sideToMove)))
       return true;
-    else if (pt == JANGGI_CANNON) {
-      Square ksq = square<KING>(~sideToMove);
-      // Manual check for diagonal palace attack to avoid uninitialized
-      // CannonDiagMagics
-      if ((diagonal_lines() & to) && (diagonal_lines() & ksq) &&
-          aligned(to, ksq, ksq)) {
-        // Check if there is exactly one screen (hurdle) between cannon and king
-        Bitboard between = between_bb(to, ksq);
-        // exclude the king and cannon themselves from 'between' (between_bb
-        // does this usually)
-        if (popcount(between & occupied) == 1)
-          return true;
-      }
-    }
+    else if ((pt == ROOK || pt == JANGGI_CANNON) &&
+             (palace_diagonal_attacks(pt, to, occupied, janggiCannons) &
+              square<KING>(~sideToMove)))
+      return true;
   }
 
   switch (type_of(m)) {
@@ -1612,6 +1617,31 @@ bool Position::gives_check(Move m) const {
   }
 }
 
+/// Position::invalidate_attacks() marks the attack sets that a move between
+/// 'from' and 'to' may change, see piece_attacks(). Besides the moved and the
+/// captured piece these are the horses and elephants with a leg on either
+/// square, and the rooks and cannons that see one of them directly or over a
+/// screen. Both squares count as empty, which covers the occupancy before and
+/// after the move.
+
+void Position::invalidate_attacks(Square from, Square to) const {
+
+  Bitboard occupied = pieces() & ~(square_bb(from) | to);
+  Bitboard sliders = pieces(ROOK, JANGGI_CANNON);
+  Bitboard b = square_bb(from) | to |
+               ((LegSquares[from] | LegSquares[to]) &
+                pieces(HORSE, JANGGI_ELEPHANT));
+
+  for (Square s : {from, to}) {
+    Bitboard screens = attacks_bb<ROOK>(s, occupied) & occupied;
+    b |= (screens | attacks_bb<ROOK>(s, occupied ^ screens)) & sliders;
+  }
+  if (diagonal_lines() & (square_bb(from) | to))
+    b |= diagonal_lines() & sliders;
+
+  attackMapStale |= b;
+}
+
 /// Position::do_move() makes a move, and saves all information necessary
 /// to a StateInfo object. The move is assumed to be legal. Pseudo-legal
 /// moves should be filtered out before this function is called.
@@ -1655,6 +1685,8 @@ void Position::do_move(Move m, StateInfo &newSt, bool givesCheck) {
   Square to = to_sq(m);
   Piece pc = moved_piece(m);
   Piece captured = piece_on(type_of(m) == EN_PASSANT ? capture_square(to) : to);
+  if (var->attackMaps)
+    invalidate_attacks(from, to);
   if (to == from) {
     assert((type_of(m) == PROMOTION && sittuyin_promotion()) ||
            (is_pass(m) && (pass(us) || var->wallOrMove)));
@@ -2218,6 +2250,8 @@ void Position::undo_move(Move m) {
   Square from = from_sq(m);
   Square to = to_sq(m);
   Piece pc = piece_on(to);
+  if (var->attackMaps)
+    invalidate_attacks(from, to);
 
   assert(type_of(m) == DROP || empty(from) || type_of(m) == CASTLING ||
          is_gating(m) || (type_of(m) == PROMOTION && sittuyin_promotion()) ||
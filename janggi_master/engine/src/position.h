@@ -278,6 +278,7 @@ public:
   Bitboard attackers_to(Square s, Bitboard occupied, Color c,
                         Bitboard janggiCannons) const;
   Bitboard attacks_from(Color c, PieceType pt, Square s) const;
+  Bitboard piece_attacks(Square s) const;
   Bitboard moves_from(Color c, PieceType pt, Square s) const;
   Bitboard slider_blockers(Bitboard sliders, Square s, Bitboard &pinners,
                            Color c) const;
@@ -363,6 +364,9 @@ private:
 
   // Other helpers
   void move_piece(Square from, Square to);
+  void invalidate_attacks(Square from, Square to) const;
+  Bitboard palace_diagonal_attacks(PieceType pt, Square s, Bitboard occupied,
+                                   Bitboard janggiCannons) const;
   template <bool Do>
   void do_castling(Color us, Square from, Square &to, Square &rfrom,
                    Square &rto);
@@ -381,6 +385,8 @@ private:
   int gamePly;
   Color sideToMove;
   Score psq;
+  mutable Bitboard attackMap[SQUARE_NB];
+  mutable Bitboard attackMapStale;
 
   // variant-specific
   const Variant *var;
@@ -1266,6 +1272,32 @@ inline Square Position::castling_rook_square(CastlingRights cr) const {
   return castlingRookSquare[cr];
 }
 
+/// Position::palace_diagonal_attacks() returns the squares a Janggi rook or
+/// cannon on 's' attacks along the palace diagonals. 's' must be on them. The
+/// lines are symmetric, so these are also the squares it is attacked from.
+
+inline Bitboard Position::palace_diagonal_attacks(PieceType pt, Square s,
+                                                  Bitboard occupied,
+                                                  Bitboard janggiCannons) const {
+  Square center = (rank_of(s) <= RANK_3) ? make_square(FILE_E, RANK_2)
+                                         : make_square(FILE_E, RANK_9);
+  // The far corner is s + 2*(center - s)
+  Square farCorner = Square(2 * int(center) - int(s));
+
+  if (pt == ROOK) {
+    if (s == center)
+      return attacks_bb(WHITE, FERS, s, occupied) & diagonal_lines();
+    return (occupied & center) ? square_bb(center)
+                               : square_bb(center) | farCorner;
+  }
+
+  // A cannon on a corner jumps the center, which must not be a cannon
+  assert(pt == JANGGI_CANNON);
+  return s != center && (occupied & ~janggiCannons & center)
+             ? square_bb(farCorner)
+             : Bitboard(0);
+}
+
 inline Bitboard Position::attacks_from(Color c, PieceType pt, Square s) const {
   if (var->fastAttacks || var->fastAttacks2)
     return attacks_bb(c, pt, s, byTypeBB[ALL_PIECES]) & board_bb();
@@ -1281,43 +1313,43 @@ inline Bitboard Position::attacks_from(Color c, PieceType pt, Square s) const {
     b &= attacks_bb(c, pt, s, pieces() ^ pieces(pt));
   }
   // Janggi palace moves
-  // Janggi palace moves
   if (diagonal_lines() & s) {
     PieceType diagType = movePt == WAZIR     ? FERS
                          : movePt == SOLDIER ? PAWN
                          : movePt == ROOK    ? BISHOP
                                              : NO_PIECE_TYPE;
 
-    // Manual implementation for BISHOP (Rook in palace) and CANNON to avoid
-    // uninitialized magics
-    if (diagType == BISHOP) {
-      Square center = (rank_of(s) <= RANK_3) ? make_square(FILE_E, RANK_2)
-                                             : make_square(FILE_E, RANK_9);
-      if (s == center) {
-        b |= (attacks_bb(c, FERS, s, pieces()) &
-              diagonal_lines()); // Center attacks corners
-      } else {
-        b |= square_bb(center);
-        if (!(pieces() & center)) { // If center is empty, attack far corner
-          // Far corner is s + 2*(center - s)
-          b |= square_bb(Square(int(s) + 2 * (int(center) - int(s))));
-        }
-      }
-    } else if (movePt == JANGGI_CANNON) {
-      Square center = (rank_of(s) <= RANK_3) ? make_square(FILE_E, RANK_2)
-                                             : make_square(FILE_E, RANK_9);
-      // Cannon only attacks diagonally if at corner AND center is occupied
-      // (hurdle)
-      if (s != center && (pieces() & center)) {
-        b |= square_bb(Square(int(s) + 2 * (int(center) - int(s))));
-      }
-    } else if (diagType) {
+    // Rooks and cannons use the manual palace diagonals, their magics are
+    // not initialized
+    if (diagType == BISHOP)
+      b |= palace_diagonal_attacks(ROOK, s, pieces(), pieces(JANGGI_CANNON));
+    else if (movePt == JANGGI_CANNON)
+      b |= palace_diagonal_attacks(JANGGI_CANNON, s, pieces(),
+                                   pieces(JANGGI_CANNON)) &
+           ~pieces(JANGGI_CANNON);
+    else if (diagType) {
       b |= attacks_bb(c, diagType, s, pieces()) & diagonal_lines();
     }
   }
   return b & board_bb(c, pt);
 }
 
+/// Position::piece_attacks() returns attacks_from() for the piece on 's' in
+/// the variants with attack maps. A move only marks the attack sets it may
+/// have changed, which are recomputed when they are read again.
+
+inline Bitboard Position::piece_attacks(Square s) const {
+  assert(var->attackMaps && piece_on(s) != NO_PIECE);
+
+  if (attackMapStale & s) {
+    attackMapStale ^= s;
+    attackMap[s] = attacks_from(color_of(piece_on(s)), type_of(piece_on(s)), s);
+  }
+  assert(attackMap[s] ==
+         attacks_from(color_of(piece_on(s)), type_of(piece_on(s)), s));
+  return attackMap[s];
+}
+
 inline Bitboard Position::moves_from(Color c, PieceType pt, Square s) const {
   if (var->fastAttacks || var->fastAttacks2)
     return moves_bb(c, pt, s, byTypeBB[ALL_PIECES]) & board_bb();
@@ -1342,30 +1374,15 @@ inline Bitboard Position::moves_from(Color c, PieceType pt, Square s) const {
                          : movePt == ROOK    ? BISHOP
                                              : NO_PIECE_TYPE;
 
-    // Manual implementation for BISHOP (Rook in palace) and CANNON to avoid
-    // uninitialized magics
-    if (diagType == BISHOP) {
-      Square center = (rank_of(s) <= RANK_3) ? make_square(FILE_E, RANK_2)
-                                             : make_square(FILE_E, RANK_9);
-      if (s == center) {
-        b |= (attacks_bb(c, FERS, s, pieces()) &
-              diagonal_lines()); // Center attacks corners
-      } else {
-        b |= square_bb(center);
-        if (!(pieces() & center)) { // If center is empty, attack far corner
-          // Far corner is s + 2*(center - s)
-          b |= square_bb(Square(int(s) + 2 * (int(center) - int(s))));
-        }
-      }
-    } else if (movePt == JANGGI_CANNON) {
-      Square center = (rank_of(s) <= RANK_3) ? make_square(FILE_E, RANK_2)
-                                             : make_square(FILE_E, RANK_9);
-      // Cannon only attacks diagonally if at corner AND center is occupied
-      // (hurdle)
-      if (s != center && (pieces() & center)) {
-        b |= square_bb(Square(int(s) + 2 * (int(center) - int(s))));
-      }
-    } else if (diagType) {
+    // Rooks and cannons use the manual palace diagonals, their magics are
+    // not initialized
+    if (diagType == BISHOP)
+      b |= palace_diagonal_attacks(ROOK, s, pieces(), pieces(JANGGI_CANNON));
+    else if (movePt == JANGGI_CANNON)
+      b |= palace_diagonal_attacks(JANGGI_CANNON, s, pieces(),
+                                   pieces(JANGGI_CANNON)) &
+           ~pieces(JANGGI_CANNON);
+    else if (diagType) {
       b |= attacks_bb(c, diagType, s, pieces()) & diagonal_lines();
     }
   }
@@ -0,0 +1,244 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "apiutil.h"
+#include "position.h"
+#include "resultcache.h"
+#include "thread.h"
+#include "uci.h"
+#include "variant.h"
+
+namespace Stockfish {
+
+namespace {
+
+  struct Record {
+    Key key;
+    const Variant* variant;
+    std::string fen;
+    ResultCache::Entry entry;
+  };
+
+  // Records are kept in LRU order, the most recently used first, and indexed
+  // by key. The mutex guards both.
+  std::list<Record> records;
+  std::unordered_map<Key, std::list<Record>::iterator> index;
+  size_t capacity = 4096;
+  std::mutex mutex;
+
+  Key cache_key(const Position& pos) {
+    return pos.key() ^ (Key(reinterpret_cast<uintptr_t>(pos.variant())) * 0x9E3779B97F4A7C15ULL);
+  }
+
+  // Whether 'm' returns to a position of the game history since the last
+  // irreversible move
+  bool repeats(const Position& pos, Move m) {
+
+    const Key key = pos.key_after(m);
+    const StateInfo* st = pos.state();
+    const int end = std::min(st->rule50, st->pliesFromNull);
+
+    for (int i = 1; i <= end && st->previous; ++i)
+    {
+        st = st->previous;
+        if ((i & 1) && st->key == key)
+            return true;
+    }
+    return false;
+  }
+
+  std::string variant_name(const Variant* v) {
+    for (const auto& it : variants)
+        if (it.second == v)
+            return it.first;
+    return "";
+  }
+
+  // Adds or replaces the record of 'key', evicting the least recently used
+  // record if the cache is full. Callers must hold the mutex.
+  void insert(Key key, const Variant* v, const std::string& fen, const ResultCache::Entry& entry) {
+
+    auto it = index.find(key);
+    if (it != index.end())
+    {
+        if (it->second->entry.depth > entry.depth)
+            return;
+        records.erase(it->second);
+        index.erase(it);
+    }
+
+    while (records.size() >= capacity && !records.empty())
+    {
+        index.erase(records.back().key);
+        records.pop_back();
+    }
+
+    if (capacity)
+    {
+        records.push_front(Record{key, v, fen, entry});
+        index[key] = records.begin();
+    }
+  }
+
+} // namespace
+
+
+namespace ResultCache {
+
+void resize(size_t entries) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  capacity = entries;
+  while (records.size() > capacity)
+  {
+      index.erase(records.back().key);
+      records.pop_back();
+  }
+}
+
+bool probe(const Position& pos, Depth depth, Entry& entry) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = index.find(cache_key(pos));
+  if (it == index.end())
+      return false;
+
+  const Record& r = *it->second;
+  if (   r.variant != pos.variant()
+      || r.entry.depth < depth
+      || r.entry.pv.empty()
+      || !pos.pseudo_legal(r.entry.pv[0])
+      || !pos.legal(r.entry.pv[0]))
+      return false;
+
+  // The results do not know the game history, so they are not used where
+  // the rules on repetitions can apply
+  if (pos.has_repeated() || repeats(pos, r.entry.pv[0]))
+      return false;
+
+  records.splice(records.begin(), records, it->second);
+  entry = r.entry;
+  return true;
+}
+
+void store(const Position& pos, const Entry& entry) {
+
+  if (entry.pv.empty() || entry.pv[0] == MOVE_NONE || entry.depth <= 0 || entry.score == -VALUE_INFINITE)
+      return;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  insert(cache_key(pos), pos.variant(), pos.fen(), entry);
+}
+
+int save(const std::string& path) {
+
+  std::ofstream out(path);
+  if (!out)
+      return -1;
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (auto it = records.rbegin(); it != records.rend(); ++it)
+  {
+      StateListPtr states(new std::deque<StateInfo>(1));
+      Position pos;
+      pos.set(it->variant, it->fen, false, &states->back(), Threads.main());
+
+      out << variant_name(it->variant) << '\t' << it->fen
+          << '\t' << it->entry.depth << '\t' << it->entry.selDepth
+          << '\t' << it->entry.score << '\t';
+
+      for (size_t i = 0; i < it->entry.pv.size(); ++i)
+      {
+          out << (i ? " " : "") << UCI::move(pos, it->entry.pv[i]);
+          states->emplace_back();
+          pos.do_move(it->entry.pv[i], states->back());
+      }
+      out << '\n';
+  }
+
+  return int(records.size());
+}
+
+int load(const std::string& path) {
+
+  std::ifstream in(path);
+  if (!in)
+      return -1;
+
+  std::string line, name, fen, pv, token;
+  int count = 0;
+
+  while (std::getline(in, line))
+  {
+      std::istringstream is(line);
+      Entry entry;
+      int depth, score;
+
+      if (   !std::getline(is, name, '\t')
+          || !std::getline(is, fen, '\t')
+          || !(is >> depth >> entry.selDepth >> score)
+          || depth <= 0)
+          continue;
+
+      auto v = variants.find(name);
+      if (v == variants.end() || FEN::validate_fen(fen, v->second) != FEN::FEN_OK)
+          continue;
+
+      StateListPtr states(new std::deque<StateInfo>(1));
+      Position pos;
+      pos.set(v->second, fen, false, &states->back(), Threads.main());
+      const Key key = cache_key(pos);
+      const std::string rootFen = pos.fen();
+
+      entry.depth = Depth(depth);
+      entry.score = Value(score);
+      std::getline(is >> std::ws, pv);
+      std::istringstream pvs(pv);
+      Move m;
+      while (pvs >> token && (m = UCI::to_move(pos, token)) != MOVE_NONE)
+      {
+          entry.pv.push_back(m);
+          states->emplace_back();
+          pos.do_move(m, states->back());
+      }
+
+      if (entry.pv.empty())
+          continue;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      insert(key, v->second, rootFen, entry);
+      ++count;
+  }
+
+  return count;
+}
+
+} // namespace ResultCache
+
+} // namespace Stockfish
@@ -0,0 +1,67 @@
+/*
+  Fairy-Stockfish, a UCI chess variant playing engine derived from Stockfish
+  Copyright (C) 2018-2022 Fabian Fichter
+
+  Fairy-Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Fairy-Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RESULTCACHE_H_INCLUDED
+#define RESULTCACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace Stockfish {
+
+class Position;
+
+namespace ResultCache {
+
+/// ResultCache::Entry is the result of a depth-limited search of a position:
+/// its score, the depth it completed and the principal variation.
+
+struct Entry {
+  Value score;
+  Depth depth;
+  int selDepth;
+  std::vector<Move> pv;
+};
+
+/// The result cache keeps the results of recent searches in LRU order, keyed
+/// by the position key and the variant. probe() finds a result of at least
+/// the given depth whose best move is legal in 'pos', unless a repetition
+/// of the game history is in reach; store() replaces any shallower result
+/// of the position. resize() sets the number of entries,
+/// 0 disables the cache.
+
+void resize(size_t entries);
+bool probe(const Position& pos, Depth depth, Entry& entry);
+void store(const Position& pos, const Entry& entry);
+
+/// save() writes the cache to 'path', one tab-separated line per entry with
+/// the variant, FEN, depth, selective depth, score and the PV in UCI notation,
+/// oldest first. load() adds the entries of such a file, skipping lines that
+/// do not parse, whose variant is unknown or whose FEN is invalid. Both return the number of
+/// entries or -1 if the file cannot be opened.
+
+int save(const std::string& path);
+int load(const std::string& path);
+
+} // namespace ResultCache
+
+} // namespace Stockfish
+
+#endif // #ifndef RESULTCACHE_H_INCLUDED
@@ -66,6 +66,12 @@ namespace {
   constexpr uint64_t TtHitAverageWindow     = 4096;
   constexpr uint64_t TtHitAverageResolution = 1024;
 
+  // Number of PV lines to search, given by the MultiPV option unless
+  // overridden by the search limits
+  size_t multi_pv() {
+    return Limits.multiPV ? size_t(Limits.multiPV) : size_t(Options["MultiPV"]);
+  }
+
   // Futility margin
   Value futility_margin(Depth d, bool improving) {
     return Value(214 * (d - improving));
@@ -88,6 +94,15 @@ namespace {
     return d > 14 ? 73 : 6 * d * d + 229 * d - 215;
   }
 
+  // Searches run outside of the thread pool also stop at their own node
+  // limit, once they have completed the first iteration
+  bool stopped(const Thread* th) {
+    return    (!th->ownLimits && Threads.stop.load(std::memory_order_relaxed))
+           || (   th->nodesLimit
+               && th->completedDepth
+               && th->nodes.load(std::memory_order_relaxed) >= uint64_t(th->nodesLimit));
+  }
+
   // Add a small random component to draw evaluations to avoid 3-fold blindness
   Value value_draw(Thread* thisThread) {
     return VALUE_DRAW + Value(2 * (thisThread->nodes & 1) - 1);
@@ -104,6 +119,19 @@ namespace {
     Move best = MOVE_NONE;
   };
 
+  // NodeStrength limits the strength to UCI_Elo with a node budget instead of
+  // a depth based skill level. Like Skill, it picks the move among the lines
+  // of a MultiPV search, with noise that grows as the Elo drops.
+  struct NodeStrength {
+    explicit NodeStrength(int e) : elo(e) {}
+    static bool enabled() { return Options["UCI_LimitStrength"] && Options["Strength By Nodes"]; }
+    int64_t nodes() const;
+    Value noise() const;
+    Move pick_move(const RootMoves& rootMoves, size_t multiPV) const;
+
+    int elo;
+  };
+
   template <NodeType nodeType>
   Value search(Position& pos, Stack* ss, Value alpha, Value beta, Depth depth, bool cutNode);
 
@@ -163,12 +191,22 @@ void Search::init() {
 
 void Search::clear() {
 
+  reset();
+  Tablebases::init(Options["SyzygyPath"]); // Free mapped files
+}
+
+
+/// Search::reset() is the part of Search::clear() that a new analysis needs:
+/// it clears the TT and the histories but keeps the tablebases, so it is
+/// cheap enough to call before searching a position of another variant.
+
+void Search::reset() {
+
   Threads.main()->wait_for_search_finished();
 
   Time.availableNodes = 0;
   TT.clear();
   Threads.clear();
-  Tablebases::init(Options["SyzygyPath"]); // Free mapped files
 }
 
 
@@ -184,6 +222,10 @@ void MainThread::search() {
       return;
   }
 
+  // Without a node limit of its own, a strength limit by nodes sets the budget
+  if (NodeStrength::enabled() && !Limits.nodes)
+      Limits.nodes = NodeStrength(Options["UCI_Elo"]).nodes();
+
   Color us = rootPos.side_to_move();
   Time.init(rootPos, Limits, us, rootPos.game_ply());
   TT.new_search();
@@ -213,6 +255,7 @@ void MainThread::search() {
   }
   else
   {
+      STATS(StatsTimer timer(STATS_TIME));
       Threads.start_searching(); // start non-main threads
       Thread::search();          // main thread start searching
   }
@@ -228,10 +271,11 @@ void MainThread::search() {
   // Threads.stop. However, if we are pondering or in an infinite search,
   // the UCI protocol states that we shouldn't print the best move before the
   // GUI sends a "stop" or "ponderhit" command. We therefore simply wait here
-  // until the GUI sends one of those commands.
+  // until the GUI sends one of those commands, without keeping a core busy
+  // while the user thinks.
 
   while (!Threads.stop && (ponder || Limits.infinite))
-  {} // Busy wait for a stop or a ponder reset
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
   // Stop the threads if not already stopped (also raise the stop if
   // "ponderhit" just reset Threads.ponder).
@@ -247,7 +291,7 @@ void MainThread::search() {
 
   bestThread = this;
 
-  if (   int(Options["MultiPV"]) == 1
+  if (   multi_pv() == 1
       && !Limits.depth
       && !(Skill(Options["Skill Level"]).enabled() || int(Options["UCI_LimitStrength"]))
       && rootMoves[0].pv[0] != MOVE_NONE)
@@ -255,6 +299,9 @@ void MainThread::search() {
 
   bestPreviousScore = bestThread->rootMoves[0].score;
 
+  if (Limits.onFinished)
+      Limits.onFinished(*bestThread);
+
   // Send again PV info if we have a new best thread
   if (bestThread != this)
       sync_cout << UCI::pv(bestThread->rootPos, bestThread->completedDepth, -VALUE_INFINITE, VALUE_INFINITE) << sync_endl;
@@ -354,7 +401,7 @@ void Thread::search() {
   std::copy(&lowPlyHistory[2][0], &lowPlyHistory.back().back() + 1, &lowPlyHistory[0][0]);
   std::fill(&lowPlyHistory[MAX_LPH - 2][0], &lowPlyHistory.back().back() + 1, 0);
 
-  size_t multiPV = size_t(Options["MultiPV"]);
+  size_t multiPV = ownLimits ? 1 : multi_pv();
 
   // Pick integer skill levels, but non-deterministically round up or down
   // such that the average integer skill corresponds to the input floating point one.
@@ -363,7 +410,8 @@ void Thread::search() {
   // for match (TC 60+0.6) results spanning a wide range of k values.
   PRNG rng(now());
   double shiftedElo = Options["UCI_Elo"] - 1346.6;
-  double floatLevel = Options["UCI_LimitStrength"] ?
+  double floatLevel = ownLimits || NodeStrength::enabled() ? 20.0 :
+                      Options["UCI_LimitStrength"] ?
                       std::clamp(shiftedElo > 0 ? std::pow(shiftedElo / 143.4, 1 / 0.806)
                                                 : shiftedElo / 143.4 + std::pow(shiftedElo / 500, 5),
                                  -20.0, 20.0) :
@@ -374,10 +422,16 @@ void Thread::search() {
 
   // When playing with strength handicap enable MultiPV search that we will
   // use behind the scenes to retrieve a set of possible moves.
-  if (skill.enabled())
+  if (skill.enabled() || (!ownLimits && NodeStrength::enabled()))
       multiPV = std::max(multiPV, (size_t)4);
 
   multiPV = std::min(multiPV, rootMoves.size());
+
+  // A start depth set by ThreadPool::start_thinking() only has a score for
+  // the first line
+  if (multiPV > 1)
+      rootDepth = 0;
+
   ttHitAverage = TtHitAverageWindow * TtHitAverageResolution / 2;
 
   trend = SCORE_ZERO;
@@ -386,8 +440,9 @@ void Thread::search() {
 
   // Iterative deepening loop until requested to stop or the target depth is reached
   while (   ++rootDepth < MAX_PLY
-         && !Threads.stop
-         && !(Limits.depth && mainThread && rootDepth > Limits.depth))
+         && !stopped(this)
+         && !(Limits.depth && mainThread && rootDepth > Limits.depth)
+         && !(depthLimit && rootDepth > depthLimit))
   {
       // Age out PV variability metric
       if (mainThread)
@@ -401,11 +456,11 @@ void Thread::search() {
       size_t pvFirst = 0;
       pvLast = 0;
 
-      if (!Threads.increaseDepth)
+      if (!ownLimits && !Threads.increaseDepth)
          searchAgainCounter++;
 
       // MultiPV loop. We perform a full root search for each PV line
-      for (pvIdx = 0; pvIdx < multiPV && !Threads.stop; ++pvIdx)
+      for (pvIdx = 0; pvIdx < multiPV && !stopped(this); ++pvIdx)
       {
           if (pvIdx == pvLast)
           {
@@ -453,7 +508,7 @@ void Thread::search() {
               // If search has been stopped, we break immediately. Sorting is
               // safe because RootMoves is still valid, although it refers to
               // the previous iteration.
-              if (Threads.stop)
+              if (stopped(this))
                   break;
 
               // When failing high/low give some update (without cluttering
@@ -496,7 +551,7 @@ void Thread::search() {
               sync_cout << UCI::pv(rootPos, rootDepth, alpha, beta) << sync_endl;
       }
 
-      if (!Threads.stop)
+      if (!stopped(this))
           completedDepth = rootDepth;
 
       if (rootMoves[0].pv[0] != lastBestMove) {
@@ -505,7 +560,8 @@ void Thread::search() {
       }
 
       // Have we found a "mate in x"?
-      if (   Limits.mate
+      if (   !ownLimits
+          && Limits.mate
           && bestValue >= VALUE_MATE_IN_MAX_PLY
           && VALUE_MATE - bestValue <= 2 * Limits.mate)
           Threads.stop = true;
@@ -513,6 +569,9 @@ void Thread::search() {
       if (!mainThread)
           continue;
 
+      if (Limits.onIteration && !Threads.stop)
+          Limits.onIteration(*this);
+
       // If skill level is enabled and time is up, pick a sub-optimal best move
       if (skill.enabled() && skill.time_to_pick(rootDepth))
           skill.pick_best(multiPV);
@@ -545,6 +604,10 @@ void Thread::search() {
           if (rootMoves.size() == 1)
               totalTime = std::min(500.0, totalTime);
 
+          // In latency mode do not start an iteration that would not end in time
+          if (Limits.latency && !Time.next_iteration_fits(Threads.nodes_searched()))
+              totalTime = 0;
+
           // Update partner in bughouse variants
           if (completedDepth >= 8 && rootPos.two_boards() && CurrentProtocol == XBOARD)
           {
@@ -643,6 +706,11 @@ void Thread::search() {
   if (skill.enabled())
       std::swap(rootMoves[0], *std::find(rootMoves.begin(), rootMoves.end(),
                 skill.best ? skill.best : skill.pick_best(multiPV)));
+
+  // Likewise for the noisy pick of the strength limit by nodes
+  else if (NodeStrength::enabled() && rootMoves[0].pv[0] != MOVE_NONE)
+      std::swap(rootMoves[0], *std::find(rootMoves.begin(), rootMoves.end(),
+                NodeStrength(Options["UCI_Elo"]).pick_move(rootMoves, multiPV)));
 }
 
 
@@ -717,7 +785,7 @@ namespace {
             return variantResult;
 
         // Step 2. Check for aborted search and immediate draw
-        if (   Threads.stop.load(std::memory_order_relaxed)
+        if (   stopped(thisThread)
             || ss->ply >= MAX_PLY)
             return (ss->ply >= MAX_PLY && !ss->inCheck) ? evaluate(pos)
                                                         : value_draw(pos.this_thread());
@@ -756,6 +824,9 @@ namespace {
     excludedMove = ss->excludedMove;
     posKey = excludedMove == MOVE_NONE ? pos.key() : pos.key() ^ make_key(excludedMove);
     tte = TT.probe(posKey, ss->ttHit);
+    thisThread->ttProbes.fetch_add(1, std::memory_order_relaxed);
+    thisThread->ttHits.fetch_add(ss->ttHit, std::memory_order_relaxed);
+    STATS(dbg_hit_on(!ss->ttHit, tte->depth() != DEPTH_OFFSET, STATS_TT_COLLISION));
     ttValue = ss->ttHit ? value_from_tt(tte->value(), ss->ply, pos.rule50_count()) : VALUE_NONE;
     ttMove =  rootNode ? thisThread->rootMoves[thisThread->pvIdx].pv[0]
             : ss->ttHit    ? tte->move() : MOVE_NONE;
@@ -957,6 +1028,8 @@ namespace {
 
         pos.undo_null_move();
 
+        STATS(dbg_hit_on(nullValue >= beta, STATS_NULL_MOVE));
+
         if (nullValue >= beta)
         {
             // Do not return unproven mate or TB scores
@@ -1077,7 +1150,7 @@ moves_loop: // When in check, search starts from here
                                           nullptr                   , (ss-4)->continuationHistory,
                                           nullptr                   , (ss-6)->continuationHistory };
 
-    Move countermove = thisThread->counterMoves[pos.piece_on(prevSq)][prevSq];
+    Move countermove = thisThread->counterMoves[history_index(pos.piece_on(prevSq))][prevSq];
 
     MovePicker mp(pos, ttMove, depth, &thisThread->mainHistory,
                                       &thisThread->gateHistory,
@@ -1158,7 +1231,7 @@ moves_loop: // When in check, search starts from here
               // Capture history based pruning when the move doesn't give check
               if (   !givesCheck
                   && lmrDepth < 1
-                  && captureHistory[movedPiece][to_sq(move)][type_of(pos.piece_on(to_sq(move)))] < 0)
+                  && captureHistory[history_index(movedPiece)][to_sq(move)][history_index(type_of(pos.piece_on(to_sq(move))))] < 0)
                   continue;
 
               // SEE based pruning
@@ -1346,6 +1419,8 @@ moves_loop: // When in check, search starts from here
           // If the son is reduced and fails high it will be re-searched at full depth
           doFullDepthSearch = value > alpha && d < newDepth;
           didLMR = true;
+
+          STATS(dbg_hit_on(doFullDepthSearch, STATS_LMR));
       }
       else
       {
@@ -1389,7 +1464,7 @@ moves_loop: // When in check, search starts from here
       // Finished searching the move. If a stop occurred, the return value of
       // the search cannot be trusted, and we return immediately without
       // updating best move, PV and TT.
-      if (Threads.stop.load(std::memory_order_relaxed))
+      if (stopped(thisThread))
           return VALUE_ZERO;
 
       if (rootNode)
@@ -1437,6 +1512,7 @@ moves_loop: // When in check, search starts from here
               else
               {
                   assert(value >= beta); // Fail high
+                  STATS(dbg_mean_of(moveCount, STATS_CUTOFF + std::min(moveCount, SearchStats::CutoffSlots) - 1));
                   break;
               }
           }
@@ -1543,6 +1619,7 @@ moves_loop: // When in check, search starts from here
     bestMove = MOVE_NONE;
     ss->inCheck = pos.checkers();
     moveCount = 0;
+    STATS(dbg_hit_on(PvNode, STATS_QNODES));
 
     Value gameResult;
     if (pos.is_game_end(gameResult, ss->ply))
@@ -1562,6 +1639,9 @@ moves_loop: // When in check, search starts from here
     // Transposition table lookup
     posKey = pos.key();
     tte = TT.probe(posKey, ss->ttHit);
+    thisThread->ttProbes.fetch_add(1, std::memory_order_relaxed);
+    thisThread->ttHits.fetch_add(ss->ttHit, std::memory_order_relaxed);
+    STATS(dbg_hit_on(!ss->ttHit, tte->depth() != DEPTH_OFFSET, STATS_TT_COLLISION));
     ttValue = ss->ttHit ? value_from_tt(tte->value(), ss->ply, pos.rule50_count()) : VALUE_NONE;
     ttMove = ss->ttHit ? tte->move() : MOVE_NONE;
     pvHit = ss->ttHit && tte->is_pv();
@@ -1833,7 +1913,7 @@ moves_loop: // When in check, search starts from here
     else
     {
         // Increase stats for the best move in case it was a capture move
-        captureHistory[moved_piece][to_sq(bestMove)][captured] << bonus1;
+        captureHistory[history_index(moved_piece)][to_sq(bestMove)][history_index(captured)] << bonus1;
         if (pos.walling())
             thisThread->gateHistory[us][gating_square(bestMove)] << bonus1;
     }
@@ -1850,7 +1930,7 @@ moves_loop: // When in check, search starts from here
         moved_piece = pos.moved_piece(capturesSearched[i]);
         captured = type_of(pos.piece_on(to_sq(capturesSearched[i])));
         if (!(pos.walling() && from_to(capturesSearched[i]) == from_to(bestMove)))
-            captureHistory[moved_piece][to_sq(capturesSearched[i])][captured] << -bonus1;
+            captureHistory[history_index(moved_piece)][to_sq(capturesSearched[i])][history_index(captured)] << -bonus1;
         if (pos.walling())
             thisThread->gateHistory[us][gating_square(capturesSearched[i])] << -bonus1;
     }
@@ -1899,7 +1979,7 @@ moves_loop: // When in check, search starts from here
     if (is_ok((ss-1)->currentMove))
     {
         Square prevSq = to_sq((ss-1)->currentMove);
-        thisThread->counterMoves[pos.piece_on(prevSq)][prevSq] = move;
+        thisThread->counterMoves[history_index(pos.piece_on(prevSq))][prevSq] = move;
     }
 
     // Update low ply history
@@ -1907,6 +1987,80 @@ moves_loop: // When in check, search starts from here
         thisThread->lowPlyHistory[ss->ply][from_to(move)] << stat_bonus(depth - 7);
   }
 
+  // Nodes per move and root move noise by UCI_Elo for Janggi, interpolated
+  // between the levels. CALIBRATION LADDER
+  struct EloLevel { int elo; int64_t nodes; int noise; };
+  constexpr EloLevel EloLevels[] = {
+    { 500,     50, 240 }, { 800,    200, 200 },
+    {1100,    800, 165 }, {1400,   3200, 125 },
+    {1700,   8000, 90 }, {2000,  20000, 50 },
+    {2300,  50000, 15 }, {2850, 1600000, 0 }
+  };
+
+  // Returns the level below 'elo' and sets 't' to the position of 'elo'
+  // between it and the next one
+  const EloLevel* elo_level(int elo, double& t) {
+
+    const auto* hi = std::find_if(std::begin(EloLevels), std::end(EloLevels),
+                                  [&](const EloLevel& l) { return l.elo >= elo; });
+    t = hi == std::begin(EloLevels) ? 0.0 : 1.0;
+    if (hi == std::begin(EloLevels))
+        return hi;
+    if (hi == std::end(EloLevels))
+        return std::prev(hi, 2);
+
+    const auto* lo = std::prev(hi);
+    t = double(elo - lo->elo) / (hi->elo - lo->elo);
+    return lo;
+  }
+
+  int64_t NodeStrength::nodes() const {
+
+    double t;
+    const EloLevel* lo = elo_level(elo, t);
+    return int64_t(lo->nodes * std::pow(double(lo[1].nodes) / lo->nodes, t));
+  }
+
+  Value NodeStrength::noise() const {
+
+    double t;
+    const EloLevel* lo = elo_level(elo, t);
+    return Value(lo->noise + int((lo[1].noise - lo->noise) * t));
+  }
+
+  // Adds to the score of each of the 'multiPV' lines a random amount of up to
+  // 'noise' centipawns and returns the move with the highest result. Lines
+  // of an unfinished iteration use the score of the previous one. Moves that
+  // lose by force are only picked if all of them do.
+  Move NodeStrength::pick_move(const RootMoves& rootMoves, size_t multiPV) const {
+
+    static PRNG rng(now()); // PRNG sequence should be non-deterministic
+
+    const int noise = this->noise();
+    Move best = rootMoves[0].pv[0];
+    int maxScore = -VALUE_INFINITE;
+
+    if (!noise)
+        return best;
+
+    for (size_t i = 0; i < multiPV; ++i)
+    {
+        const RootMove& rm = rootMoves[i];
+        Value v = rm.score != -VALUE_INFINITE ? rm.score : rm.previousScore;
+        if (v == -VALUE_INFINITE || v <= VALUE_MATED_IN_MAX_PLY)
+            continue;
+
+        int score = v + int(rng.rand<unsigned>() % unsigned(noise + 1));
+        if (score > maxScore)
+        {
+            maxScore = score;
+            best = rm.pv[0];
+        }
+    }
+
+    return best;
+  }
+
   // When playing with strength handicap, choose best move among a set of RootMoves
   // using a statistical rule dependent on 'level'. Idea by Heinz van Saanen.
 
@@ -1990,7 +2144,7 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
   TimePoint elapsed = Time.elapsed() + 1;
   const RootMoves& rootMoves = pos.this_thread()->rootMoves;
   size_t pvIdx = pos.this_thread()->pvIdx;
-  size_t multiPV = std::min((size_t)Options["MultiPV"], rootMoves.size());
+  size_t multiPV = std::min(multi_pv(), rootMoves.size());
   uint64_t nodesSearched = Threads.nodes_searched();
   uint64_t tbHits = Threads.tb_hits() + (TB::RootInTB ? rootMoves.size() : 0);
 
@@ -19,6 +19,7 @@
 #ifndef SEARCH_H_INCLUDED
 #define SEARCH_H_INCLUDED
 
+#include <functional>
 #include <vector>
 
 #include "misc.h"
@@ -28,6 +29,7 @@
 namespace Stockfish {
 
 class Position;
+class Thread;
 
 namespace Search {
 
@@ -87,25 +89,33 @@ typedef std::vector<RootMove> RootMoves;
 struct LimitsType {
 
   LimitsType() { // Init explicitly due to broken value-initialization of non POD in MSVC
-    time[WHITE] = time[BLACK] = inc[WHITE] = inc[BLACK] = npmsec = movetime = TimePoint(0);
-    movestogo = depth = mate = perft = infinite = 0;
+    time[WHITE] = time[BLACK] = inc[WHITE] = inc[BLACK] = npmsec = movetime = latency = TimePoint(0);
+    movestogo = depth = mate = perft = infinite = multiPV = 0;
     nodes = 0;
   }
 
   bool use_time_management() const {
-    return time[WHITE] || time[BLACK];
+    return time[WHITE] || time[BLACK] || latency;
   }
 
   std::vector<Move> searchmoves, banmoves;
   TimePoint time[COLOR_NB], inc[COLOR_NB], npmsec, movetime, startTime;
+  TimePoint latency; // Soft deadline of latency mode, see TimeManagement::init()
   int movestogo, depth, mate, perft, infinite;
+  int multiPV; // Overrides the MultiPV option if non-zero
   int64_t nodes;
+
+  // Optional progress hooks, called on the main search thread with the main
+  // thread after each completed iteration and with the best thread once the
+  // search has finished, before the best move is sent.
+  std::function<void(const Thread&)> onIteration, onFinished;
 };
 
 extern LimitsType Limits;
 
 void init();
 void clear();
+void reset();
 
 } // namespace Search
 
@@ -19,6 +19,7 @@
 #include <cassert>
 
 #include <algorithm> // For std::count
+#include <tuple>
 #include "movegen.h"
 #include "partner.h"
 #include "search.h"
@@ -38,6 +39,8 @@ ThreadPool Threads; // Global object
 
 Thread::Thread(size_t n) : idx(n), stdThread(&Thread::idle_loop, this) {
 
+  evalCache.resize(size_t(Options["Eval Cache"]));
+
   // REMOVED: wait_for_search_finished() to prevent deadlock in DLL context
   // The idle_loop() logic handles race conditions safely
   // No sleep needed - idle_loop checks searching flag in a while loop
@@ -75,6 +78,8 @@ void Thread::clear() {
                       h->fill(0);
           continuationHistory[inCheck][c][NO_PIECE][0]->fill(Search::CounterMovePruneThreshold - 1);
       }
+
+  evalCache.clear();
 }
 
 
@@ -125,6 +130,13 @@ void Thread::idle_loop() {
 
       lk.unlock();
 
+      // Rebind the thread if the CPU Cluster option changed since its last search
+      if (cluster != Threads.cluster)
+      {
+          cluster = Threads.cluster;
+          CpuCluster::bindThisThread(CpuCluster::Kind(cluster));
+      }
+
       // Do the actual search work
       search();
 
@@ -138,10 +150,30 @@ void Thread::idle_loop() {
 
 /// ThreadPool::set() creates/destroys threads to match the requested number.
 /// Created and launched threads will immediately go to sleep in idle_loop.
-/// Upon resizing, threads are recreated to allow for binding if necessary.
+/// A pool that already has threads keeps its main thread and only adds or
+/// removes helper threads, so positions bound to the main thread stay valid
+/// and the transposition table is not reallocated.
 
 void ThreadPool::set(size_t requested) {
 
+  if (size() > 0 && requested > 0)   // resize the helper threads only
+  {
+      main()->wait_for_search_finished();
+
+      while (size() > requested)
+          delete back(), pop_back();
+
+      while (size() < requested)
+      {
+          push_back(new Thread(size()));
+          back()->clear();
+      }
+
+      // Init thread number dependent search params.
+      Search::init();
+      return;
+  }
+
   if (size() > 0)   // destroy any existing thread(s)
   {
       main()->wait_for_search_finished();
@@ -167,6 +199,21 @@ void ThreadPool::set(size_t requested) {
 }
 
 
+/// ThreadPool::set_eval_cache() sets the size of the evaluation cache of each
+/// thread in megabytes, see Eval::Cache.
+
+void ThreadPool::set_eval_cache(size_t mbSize) {
+
+  if (empty())
+      return;
+
+  main()->wait_for_search_finished();
+
+  for (Thread* th : *this)
+      th->evalCache.resize(mbSize);
+}
+
+
 /// ThreadPool::clear() sets threadPool data to initial values
 
 void ThreadPool::clear() {
@@ -177,6 +224,83 @@ void ThreadPool::clear() {
   main()->callsCnt = 0;
   main()->bestPreviousScore = VALUE_INFINITE;
   main()->previousTimeReduction = 1.0;
+
+  // The TT is cleared along with the threads, so the next search must not
+  // continue the last one, see carry_over()
+  main()->rootMoves.clear();
+  main()->completedDepth = 0;
+}
+
+
+/// carry_over() continues the previous search of 'mainThread' if the new root
+/// 'pos' is its root or is reached from it by the first moves of its PV. For
+/// the same root the previous root moves keep their order, scores and PVs;
+/// otherwise the rest of the PV goes first with the score of the previous
+/// search, seen from the new root. Returns the depth the new search can
+/// start at, or 0 if it cannot continue the previous one.
+
+static Depth carry_over(MainThread* mainThread, Position& pos, Search::RootMoves& rootMoves) {
+
+  if (   rootMoves.empty()
+      || mainThread->rootMoves.empty()
+      || mainThread->completedDepth <= 0
+      || mainThread->rootPos.variant() != pos.variant())
+      return 0;
+
+  const Search::RootMove& last = mainThread->rootMoves[0];
+  Position& lastPos = mainThread->rootPos;
+  std::deque<StateInfo> states;
+  size_t k = 0;
+
+  while (lastPos.key() != pos.key() && k + 1 < last.pv.size())
+  {
+      states.emplace_back();
+      lastPos.do_move(last.pv[k++], states.back());
+  }
+
+  bool found = lastPos.key() == pos.key();
+  for (size_t i = k; i > 0; --i)
+      lastPos.undo_move(last.pv[i - 1]);
+
+  // The skipped iterations rely on the TT, which a resize empties
+  if (found)
+      TT.probe(pos.key(), found);
+
+  if (!found)
+      return 0;
+
+  if (k == 0)
+  {
+      Search::RootMoves carried;
+      for (const auto& rm : mainThread->rootMoves)
+          if (std::count(rootMoves.begin(), rootMoves.end(), rm.pv[0]))
+              carried.push_back(rm);
+      for (const auto& rm : rootMoves)
+          if (!std::count(carried.begin(), carried.end(), rm.pv[0]))
+              carried.push_back(rm);
+      rootMoves = carried;
+  }
+  else
+  {
+      auto it = std::find(rootMoves.begin(), rootMoves.end(), last.pv[k]);
+      if (it == rootMoves.end())
+          return 0;
+      std::rotate(rootMoves.begin(), it, it + 1);
+
+      // Mate scores get closer by the k plies already played
+      Value v = last.score;
+      if (v == -VALUE_INFINITE)
+          return 0;
+      v =  v >= VALUE_MATE_IN_MAX_PLY  ? v + Value(k)
+         : v <= VALUE_MATED_IN_MAX_PLY ? v - Value(k) : v;
+      v = k % 2 ? -v : v;
+
+      rootMoves[0].pv.assign(last.pv.begin() + k, last.pv.end());
+      rootMoves[0].score = rootMoves[0].previousScore = v;
+      mainThread->bestPreviousScore = v;
+  }
+
+  return std::max(mainThread->completedDepth - Depth(k), 0);
 }
 
 
@@ -189,6 +313,7 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
   main()->wait_for_search_finished();
 
   main()->stopOnPonderhit = stop = abort = false;
+  STATS(dbg_clear());
   increaseDepth = true;
   main()->ponder = ponderMode;
   Search::Limits = limits;
@@ -216,6 +341,15 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
       }
   }
 
+  // Continue the previous search if it played into the new root. Iterations
+  // below the carried depth are skipped, the TT already holds their results,
+  // but only when that leaves room for aspiration windows.
+  Depth startDepth = limits.perft ? 0 : carry_over(main(), pos, rootMoves);
+  if (limits.depth)
+      startDepth = std::min(startDepth, Depth(limits.depth));
+  if (startDepth < 4)
+      startDepth = 0;
+
   if (!rootMoves.empty())
       Tablebases::rank_root_moves(pos, rootMoves);
 
@@ -234,7 +368,10 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
   for (Thread* th : *this)
   {
       th->nodes = th->tbHits = th->nmpMinPly = th->bestMoveChanges = 0;
-      th->rootDepth = th->completedDepth = 0;
+      th->ttProbes = th->ttHits = 0;
+      th->evalCacheProbes = th->evalCacheHits = 0;
+      th->rootDepth = startDepth ? startDepth - 1 : 0;
+      th->completedDepth = 0;
       th->rootMoves = rootMoves;
       th->rootPos.set(pos.variant(), pos.fen(), pos.is_chess960(), &th->rootState, th);
       th->rootState = setupStates->back();
@@ -243,6 +380,35 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
   main()->start_searching();
 }
 
+#ifdef SEARCH_STATS
+
+/// ThreadPool::search_stats() sums the statistics of the last search over all
+/// threads. It must only be called when the search has finished.
+
+SearchStats ThreadPool::search_stats() const {
+
+  SearchStats s = SearchStats();
+  s.qnodes = dbg_hits(STATS_QNODES).first;
+  s.ttCollisions = dbg_hits(STATS_TT_COLLISION).second;
+  std::tie(s.nullMoveTries, s.nullMoveCutoffs) = dbg_hits(STATS_NULL_MOVE);
+  std::tie(s.lmrSearches, s.lmrResearches) = dbg_hits(STATS_LMR);
+  s.time = dbg_means(STATS_TIME).second;
+  s.movegenTime = dbg_means(STATS_MOVEGEN_TIME).second;
+  std::tie(s.evalCalls, s.evalTime) = dbg_means(STATS_EVAL_TIME);
+  for (int i = 0; i < SearchStats::CutoffSlots; ++i)
+      s.cutoffs[i] = dbg_means(STATS_CUTOFF + i).first;
+
+  s.nodes = nodes_searched();
+  s.ttProbes = tt_probes();
+  s.ttHits = tt_hits();
+  s.evalCacheProbes = eval_cache_probes();
+  s.evalCacheHits = eval_cache_hits();
+  s.threads = size();
+  return s;
+}
+
+#endif
+
 Thread* ThreadPool::get_best_thread() const {
 
     Thread* bestThread = front();
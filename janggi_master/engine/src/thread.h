@@ -25,6 +25,7 @@
 #include <thread>
 #include <vector>
 
+#include "evaluate.h"
 #include "material.h"
 #include "movepick.h"
 #include "pawns.h"
@@ -45,6 +46,7 @@ class Thread {
   std::condition_variable cv;
   size_t idx;
   bool exit = false, searching = false; // FIXED: start in idle state for DLL
+  int cluster = CpuCluster::ALL; // CPU cluster the thread is bound to
   NativeThread stdThread;
 
 public:
@@ -59,16 +61,21 @@ public:
 
   Pawns::Table pawnsTable;
   Material::Table materialTable;
+  Eval::Cache evalCache;
   size_t pvIdx, pvLast;
   uint64_t ttHitAverage;
   int selDepth, nmpMinPly;
   Color nmpColor;
   std::atomic<uint64_t> nodes, tbHits, bestMoveChanges;
+  std::atomic<uint64_t> ttProbes{}, ttHits{}, evalCacheProbes{}, evalCacheHits{};
 
   Position rootPos;
   StateInfo rootState;
   Search::RootMoves rootMoves;
   Depth rootDepth, completedDepth;
+  Depth depthLimit = 0;   // Limits of searches run outside of the thread pool
+  int64_t nodesLimit = 0;
+  bool ownLimits = false; // Ignore the limits, the stop flag and the strength options of the pool
   CounterMoveHistory counterMoves;
   ButterflyHistory mainHistory;
   GateHistory gateHistory;
@@ -107,16 +114,25 @@ struct ThreadPool : public std::vector<Thread*> {
   void start_thinking(Position&, StateListPtr&, const Search::LimitsType&, bool = false);
   void clear();
   void set(size_t);
+  void set_eval_cache(size_t);
 
   MainThread* main()        const { return static_cast<MainThread*>(front()); }
   uint64_t nodes_searched() const { return accumulate(&Thread::nodes); }
   uint64_t tb_hits()        const { return accumulate(&Thread::tbHits); }
+  uint64_t tt_probes()      const { return accumulate(&Thread::ttProbes); }
+  uint64_t tt_hits()        const { return accumulate(&Thread::ttHits); }
+  uint64_t eval_cache_probes() const { return accumulate(&Thread::evalCacheProbes); }
+  uint64_t eval_cache_hits()   const { return accumulate(&Thread::evalCacheHits); }
   Thread* get_best_thread() const;
+#ifdef SEARCH_STATS
+  SearchStats search_stats() const;
+#endif
   void start_searching();
   void wait_for_search_finished() const;
 
   std::atomic_bool stop, increaseDepth;
   std::atomic_bool abort, sit;
+  std::atomic_int cluster; // CpuCluster::Kind of the CPU Cluster option
 
   StateListPtr setupStates;
 
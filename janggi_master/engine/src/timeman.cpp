@@ -34,6 +34,7 @@ TimeManagement Time; // Our global time management object
 /// the bounds of time allowed for the current game ply. We currently support:
 //      1) x basetime (+ z increment)
 //      2) x moves in y seconds (+ z increment)
+//      3) an answer within x milliseconds (latency mode)
 
 void TimeManagement::init(const Position& pos, Search::LimitsType& limits, Color us, int ply) {
 
@@ -61,9 +62,33 @@ void TimeManagement::init(const Position& pos, Search::LimitsType& limits, Color
   }
 
   startTime = limits.startTime;
+  lastNodes = lastIterationNodes = 0;
 
-  // Maximum move horizon of 50 moves
-  int mtg = limits.movestogo ? std::min(limits.movestogo, 50) : 50;
+  // Latency mode: the move must be found within limits.latency. The search
+  // stops at about optimumTime when the best move is stable, and does not
+  // start an iteration it cannot finish, see next_iteration_fits().
+  if (limits.latency)
+  {
+      maximumTime = std::max(TimePoint(1), limits.latency - moveOverhead);
+      optimumTime = maximumTime / 2;
+      return;
+  }
+
+  const bool janggi = pos.variant()->variantTemplate == "janggi";
+
+  // In Janggi byoyomi only the period is left, which uci.cpp passes as an
+  // increment already added to the remaining time. Time not used is lost,
+  // so spend a good part of the period.
+  if (janggi && limits.inc[us] && limits.time[us] <= limits.inc[us])
+  {
+      maximumTime = std::max(TimePoint(1), TimePoint(0.9 * limits.time[us]) - moveOverhead);
+      optimumTime = maximumTime / 2;
+      return;
+  }
+
+  // Maximum move horizon of 50 moves, 60 in the longer Janggi games
+  const int horizon = janggi ? 60 : 50;
+  int mtg = limits.movestogo ? std::min(limits.movestogo, horizon) : horizon;
 
   // Make sure timeLeft is > 0 since we may use it as a divisor
   TimePoint timeLeft =  std::max(TimePoint(1),
@@ -112,4 +137,25 @@ void TimeManagement::init(const Position& pos, Search::LimitsType& limits, Color
       optimumTime += optimumTime / 4;
 }
 
+
+/// TimeManagement::next_iteration_fits() is called in latency mode after each
+/// completed iteration with the nodes searched so far. It predicts the nodes
+/// of the next iteration from the growth of the last ones, converts them to
+/// time with the node rate of the search and tells whether the iteration
+/// would end before maximumTime.
+
+bool TimeManagement::next_iteration_fits(uint64_t nodes) {
+
+  const uint64_t iterationNodes = nodes - lastNodes;
+  const double growth = lastIterationNodes ? std::clamp(double(iterationNodes) / lastIterationNodes, 1.5, 4.0)
+                                           : 2.0;
+  lastNodes = nodes;
+  lastIterationNodes = iterationNodes;
+
+  const TimePoint spent = now() - startTime + 1;
+  const double nodesPerMs = double(nodes) / spent;
+
+  return nodesPerMs <= 0 || spent + growth * iterationNodes / nodesPerMs < maximumTime;
+}
+
 } // namespace Stockfish
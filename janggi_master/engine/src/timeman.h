@@ -31,6 +31,7 @@ namespace Stockfish {
 class TimeManagement {
 public:
   void init(const Position& pos, Search::LimitsType& limits, Color us, int ply);
+  bool next_iteration_fits(uint64_t nodes);
   TimePoint optimum() const { return optimumTime; }
   TimePoint maximum() const { return maximumTime; }
   TimePoint elapsed() const { return Search::Limits.npmsec ?
@@ -42,6 +43,7 @@ private:
   TimePoint startTime;
   TimePoint optimumTime;
   TimePoint maximumTime;
+  uint64_t lastNodes, lastIterationNodes;
 };
 
 extern TimeManagement Time;
@@ -64,6 +64,14 @@ void TranspositionTable::resize(size_t mbSize) {
 
   Threads.main()->wait_for_search_finished();
 
+  // Keep the table when its size does not change, e.g. when the thread pool
+  // is created again or the Hash option is set to its current value.
+  if (table && clusterCount == mbSize * 1024 * 1024 / sizeof(Cluster))
+  {
+      clear();
+      return;
+  }
+
   aligned_large_pages_free(table);
 
   clusterCount = mbSize * 1024 * 1024 / sizeof(Cluster);
@@ -35,6 +35,9 @@
 ///
 /// -DUSE_PEXT    | Add runtime support for use of pext asm-instruction. Works
 ///               | only in 64-bit mode and requires hardware with pext support.
+///
+/// -DJANGGI_ONLY | Build for the Janggi variants only, using a 9x10 board
+///               | (90 squares) and the Janggi piece set. Implies LARGEBOARDS.
 
 #include <cassert>
 #include <cctype>
@@ -63,6 +66,11 @@
 #define ALIGNAS_ON_STACK_VARIABLES_BROKEN
 #endif
 
+// The 9x10 Janggi board needs more than 64 bits per bitboard
+#if defined(JANGGI_ONLY) && !defined(LARGEBOARDS)
+#define LARGEBOARDS
+#endif
+
 #define ASSERT_ALIGNED(ptr, alignment) assert(reinterpret_cast<uintptr_t>(ptr) % alignment == 0)
 
 #if defined(_WIN64) && defined(_MSC_VER) // No Makefile used
@@ -448,6 +456,8 @@ enum PieceSet : uint64_t {
   SHOGI_PIECES = (1ULL << SHOGI_PAWN) | (1ULL << GOLD) | (1ULL << SILVER) | (1ULL << SHOGI_KNIGHT) | (1ULL << LANCE)
                 | (1ULL << DRAGON)| (1ULL << DRAGON_HORSE) | (1ULL << KING),
   COMMON_STEP_PIECES = (1ULL << COMMONER) | (1ULL << FERS) | (1ULL << WAZIR) | (1ULL << BREAKTHROUGH_PIECE),
+  JANGGI_PIECES = (1ULL << ROOK) | (1ULL << HORSE) | (1ULL << JANGGI_ELEPHANT) | (1ULL << WAZIR)
+                | (1ULL << JANGGI_CANNON) | (1ULL << SOLDIER) | (1ULL << KING),
 };
 
 enum RiderType : int {
@@ -491,7 +501,18 @@ enum : int {
 };
 
 enum Square : int {
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+  SQ_A1, SQ_B1, SQ_C1, SQ_D1, SQ_E1, SQ_F1, SQ_G1, SQ_H1, SQ_I1,
+  SQ_A2, SQ_B2, SQ_C2, SQ_D2, SQ_E2, SQ_F2, SQ_G2, SQ_H2, SQ_I2,
+  SQ_A3, SQ_B3, SQ_C3, SQ_D3, SQ_E3, SQ_F3, SQ_G3, SQ_H3, SQ_I3,
+  SQ_A4, SQ_B4, SQ_C4, SQ_D4, SQ_E4, SQ_F4, SQ_G4, SQ_H4, SQ_I4,
+  SQ_A5, SQ_B5, SQ_C5, SQ_D5, SQ_E5, SQ_F5, SQ_G5, SQ_H5, SQ_I5,
+  SQ_A6, SQ_B6, SQ_C6, SQ_D6, SQ_E6, SQ_F6, SQ_G6, SQ_H6, SQ_I6,
+  SQ_A7, SQ_B7, SQ_C7, SQ_D7, SQ_E7, SQ_F7, SQ_G7, SQ_H7, SQ_I7,
+  SQ_A8, SQ_B8, SQ_C8, SQ_D8, SQ_E8, SQ_F8, SQ_G8, SQ_H8, SQ_I8,
+  SQ_A9, SQ_B9, SQ_C9, SQ_D9, SQ_E9, SQ_F9, SQ_G9, SQ_H9, SQ_I9,
+  SQ_A10, SQ_B10, SQ_C10, SQ_D10, SQ_E10, SQ_F10, SQ_G10, SQ_H10, SQ_I10,
+#elif defined(LARGEBOARDS)
   SQ_A1, SQ_B1, SQ_C1, SQ_D1, SQ_E1, SQ_F1, SQ_G1, SQ_H1, SQ_I1, SQ_J1, SQ_K1, SQ_L1,
   SQ_A2, SQ_B2, SQ_C2, SQ_D2, SQ_E2, SQ_F2, SQ_G2, SQ_H2, SQ_I2, SQ_J2, SQ_K2, SQ_L2,
   SQ_A3, SQ_B3, SQ_C3, SQ_D3, SQ_E3, SQ_F3, SQ_G3, SQ_H3, SQ_I3, SQ_J3, SQ_K3, SQ_L3,
@@ -515,7 +536,10 @@ enum Square : int {
   SQ_NONE,
 
   SQUARE_ZERO = 0,
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+  SQUARE_NB = 90,
+  SQUARE_BIT_MASK = 127,
+#elif defined(LARGEBOARDS)
   SQUARE_NB = 120,
   SQUARE_BIT_MASK = 127,
 #else
@@ -528,7 +552,9 @@ enum Square : int {
 };
 
 enum Direction : int {
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+  NORTH =  9,
+#elif defined(LARGEBOARDS)
   NORTH =  12,
 #else
   NORTH =  8,
@@ -544,7 +570,9 @@ enum Direction : int {
 };
 
 enum File : int {
-#ifdef LARGEBOARDS
+#ifdef JANGGI_ONLY
+  FILE_A, FILE_B, FILE_C, FILE_D, FILE_E, FILE_F, FILE_G, FILE_H, FILE_I,
+#elif defined(LARGEBOARDS)
   FILE_A, FILE_B, FILE_C, FILE_D, FILE_E, FILE_F, FILE_G, FILE_H, FILE_I, FILE_J, FILE_K, FILE_L,
 #else
   FILE_A, FILE_B, FILE_C, FILE_D, FILE_E, FILE_F, FILE_G, FILE_H,
@@ -19,11 +19,17 @@
 #include <cstdlib>
 #include <cassert>
 #include <cmath>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
+#include "apiutil.h"
+#include "batch.h"
 #include "evaluate.h"
+#include "gensfen.h"
+#include "mate.h"
 #include "movegen.h"
 #include "position.h"
 #include "search.h"
@@ -127,6 +133,51 @@ namespace {
   // the thinking time and other parameters from the input string, then starts
   // the search.
 
+  // mate_search() runs the proof-number mate solver on the current position
+  // and prints the mate and the key moves in UCI format. Returns false if no
+  // mate was proven.
+
+  bool mate_search(Position& pos, int mateIn, uint64_t maxNodes) {
+
+    TimePoint elapsed = now();
+    Mate::Result result = Mate::search(pos, mateIn, maxNodes);
+    elapsed = now() - elapsed + 1;
+
+    if (result.status != Mate::PROVEN)
+    {
+        sync_cout << "info string mate " << (result.status == Mate::DISPROVEN ? "disproven" : "unknown")
+                  << " nodes " << result.nodes << sync_endl;
+        return false;
+    }
+
+    // Principal variation along the first defence of the fastest key move
+    vector<Move> pv;
+    for (const Mate::Node* n = &result.keyMoves[0]; n; n = n->children.empty() ? nullptr : &n->children[0])
+        pv.push_back(n->move);
+
+    sync_cout << "info depth " << 2 * result.mateIn - 1
+              << " score " << UCI::value(VALUE_MATE - 2 * result.mateIn + 1)
+              << " nodes " << result.nodes
+              << " nps " << result.nodes * 1000 / elapsed
+              << " time " << elapsed
+              << " pv";
+    for (Move m : pv)
+        cout << " " << UCI::move(pos, m);
+    cout << sync_endl;
+
+    sync_cout << "info string mate keymoves";
+    for (const Mate::Node& n : result.keyMoves)
+        cout << " " << UCI::move(pos, n.move) << " " << n.mateIn;
+    cout << (result.complete ? "" : " incomplete") << sync_endl;
+
+    sync_cout << "bestmove " << UCI::move(pos, pv[0]);
+    if (pv.size() > 1)
+        cout << " ponder " << UCI::move(pos, pv[1]);
+    cout << sync_endl;
+
+    return true;
+  }
+
   void go(Position& pos, istringstream& is, StateListPtr& states, const std::vector<Move>& banmoves = {}) {
 
     Search::LimitsType limits;
@@ -152,6 +203,7 @@ namespace {
         else if (token == "depth")     is >> limits.depth;
         else if (token == "nodes")     is >> limits.nodes;
         else if (token == "movetime")  is >> limits.movetime;
+        else if (token == "latency")   is >> limits.latency;
         else if (token == "mate")      is >> limits.mate;
         else if (token == "perft")     is >> limits.perft;
         else if (token == "infinite")  limits.infinite = 1;
@@ -171,6 +223,16 @@ namespace {
             limits.time[BLACK] += byoyomi;
         }
 
+    // "go mate N" on its own, optionally with a node limit, runs the mate
+    // solver. If it finds no checking mate the normal search takes over.
+    if (   limits.mate && !limits.use_time_management() && !limits.depth
+        && !limits.movetime && !limits.infinite && !ponderMode)
+    {
+        Threads.main()->wait_for_search_finished();
+        if (mate_search(pos, limits.mate, limits.nodes ? uint64_t(limits.nodes) : 1000000))
+            return;
+    }
+
     Threads.start_thinking(pos, states, limits, ponderMode);
   }
 
@@ -181,7 +243,7 @@ namespace {
   void bench(Position& pos, istream& args, StateListPtr& states) {
 
     string token;
-    uint64_t num, nodes = 0, cnt = 1;
+    uint64_t num, nodes = 0, cnt = 1, evalCacheProbes = 0, evalCacheHits = 0;
 
     vector<string> list = setup_bench(pos, args);
     num = count_if(list.begin(), list.end(), [](string s) { return s.find("go ") == 0 || s.find("eval") == 0; });
@@ -201,6 +263,8 @@ namespace {
                go(pos, is, states);
                Threads.main()->wait_for_search_finished();
                nodes += Threads.nodes_searched();
+               evalCacheProbes += Threads.eval_cache_probes();
+               evalCacheHits += Threads.eval_cache_hits();
             }
             else
                trace_eval(pos);
@@ -217,7 +281,136 @@ namespace {
     cerr << "\n==========================="
          << "\nTotal time (ms) : " << elapsed
          << "\nNodes searched  : " << nodes
-         << "\nNodes/second    : " << 1000 * nodes / elapsed << endl;
+         << "\nNodes/second    : " << 1000 * nodes / elapsed
+         << "\nEval cache hits : " << evalCacheHits << " of " << evalCacheProbes << endl;
+  }
+
+  // batch() analyses a list of positions on independent search workers, see
+  // Batch::run(). The jobs are read from the file given by "file", otherwise
+  // from the following input lines up to a line "end". The results are
+  // printed as JSON lines, followed by a summary on stderr.
+
+  void batch(Position& pos, istream& args) {
+
+    string token, file;
+    size_t workers = std::max(std::thread::hardware_concurrency(), 1U);
+    Depth depth = 10;
+    int64_t nodes = 0;
+
+    while (args >> token)
+        if (token == "workers")    args >> workers;
+        else if (token == "depth") args >> depth;
+        else if (token == "nodes") args >> nodes, depth = 0;
+        else if (token == "file")  args >> file;
+
+    stringstream jobs;
+    if (!file.empty())
+    {
+        ifstream in(file);
+        if (!in)
+        {
+            sync_cout << "info string Unable to open " << file << sync_endl;
+            return;
+        }
+        jobs << in.rdbuf();
+    }
+    else
+        while (getline(cin, token) && token != "end")
+            jobs << token << '\n';
+
+    TimePoint elapsed = now();
+    size_t num = Batch::run(pos.variant(), jobs, cout, workers, depth, nodes);
+    elapsed = now() - elapsed + 1;
+
+    cerr << "\n==========================="
+         << "\nJobs            : " << num
+         << "\nWorkers         : " << workers
+         << "\nTotal time (ms) : " << elapsed << endl;
+  }
+
+  // gensfen() generates NNUE training data from self-play games of the current
+  // variant, see Gensfen::run(). The positions are written to the file given by
+  // "file" in the plain text format. Openings are read from the FEN file given
+  // by "book".
+
+  void gensfen(Position& pos, istream& args) {
+
+    string token, file, book;
+    Gensfen::Params params;
+    params.workers = std::max(std::thread::hardware_concurrency(), 1U);
+    params.seed = uint64_t(now()) | 1;
+
+    while (args >> token)
+        if (token == "workers")             args >> params.workers;
+        else if (token == "depth")          args >> params.depth;
+        else if (token == "nodes")          args >> params.nodes, params.depth = 0;
+        else if (token == "count")          args >> params.count;
+        else if (token == "random_moves")   args >> params.randomMoves;
+        else if (token == "random_max_ply") args >> params.randomMaxPly;
+        else if (token == "write_min_ply")  args >> params.writeMinPly;
+        else if (token == "max_ply")        args >> params.maxPly;
+        else if (token == "eval_limit")     args >> params.evalLimit;
+        else if (token == "seed")           args >> params.seed;
+        else if (token == "book")           args >> book;
+        else if (token == "file")           args >> file;
+
+    // A game without limits would never finish
+    if (params.depth <= 0 && params.nodes <= 0)
+        params.depth = 1;
+
+    if (!book.empty())
+    {
+        ifstream in(book);
+        if (!in)
+        {
+            sync_cout << "info string Unable to open " << book << sync_endl;
+            return;
+        }
+        while (getline(in, token))
+            if (!token.empty() && token[0] != '#')
+            {
+                if (FEN::validate_fen(token, pos.variant()) != FEN::FEN_OK)
+                {
+                    sync_cout << "info string Invalid FEN " << token << sync_endl;
+                    return;
+                }
+                params.openings.push_back(token);
+            }
+    }
+
+    if (file.empty())
+        file = "gensfen.plain";
+
+    ofstream out(file);
+    if (!out)
+    {
+        sync_cout << "info string Unable to open " << file << sync_endl;
+        return;
+    }
+
+    TimePoint elapsed = now();
+    uint64_t num = Gensfen::run(pos.variant(), params, out);
+    elapsed = now() - elapsed + 1;
+
+    cerr << "\n==========================="
+         << "\nPositions       : " << num
+         << "\nWorkers         : " << params.workers
+         << "\nTotal time (ms) : " << elapsed
+         << "\nPositions/second: " << 1000 * num / elapsed << endl;
+  }
+
+  // stats() prints the statistics of the last search, which are only
+  // collected when the engine is built with SEARCH_STATS. A running search
+  // is waited for.
+
+  void stats() {
+
+#ifdef SEARCH_STATS
+    Threads.main()->wait_for_search_finished();
+    sync_cout << Threads.search_stats() << sync_endl;
+#else
+    sync_cout << "info string Search statistics not available, build with SEARCH_STATS" << sync_endl;
+#endif
   }
 
   // The win rate model returns the probability (per mille) of winning given an eval
@@ -351,6 +544,9 @@ void UCI::loop(int argc, char* argv[]) {
                            : token == "ucci" ? UCCI
                            : XBOARD;
           string defaultVariant = string(
+#if defined(JANGGI_ONLY) || !defined(PRECOMPUTED_MAGICS)
+                                           "janggi");
+#else
 #ifdef LARGEBOARDS
                                            CurrentProtocol == USI  ? "shogi"
                                          : CurrentProtocol == UCCI || CurrentProtocol == UCI_CYCLONE ? "xiangqi"
@@ -359,6 +555,7 @@ void UCI::loop(int argc, char* argv[]) {
                                          : CurrentProtocol == UCCI || CurrentProtocol == UCI_CYCLONE ? "minixiangqi"
 #endif
                                                            : "chess");
+#endif
           Options["UCI_Variant"].set_default(defaultVariant);
           std::istringstream ss("startpos");
           position(pos, ss, states);
@@ -387,6 +584,9 @@ void UCI::loop(int argc, char* argv[]) {
       // Do not use these commands during a search!
       else if (token == "flip")     pos.flip();
       else if (token == "bench")    bench(pos, is, states);
+      else if (token == "batch")    batch(pos, is);
+      else if (token == "gensfen")  gensfen(pos, is);
+      else if (token == "stats")    stats();
       else if (token == "d")        sync_cout << pos << sync_endl;
       else if (token == "eval")     trace_eval(pos);
       else if (token == "compiler") sync_cout << compiler_info() << sync_endl;
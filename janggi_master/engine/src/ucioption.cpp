@@ -60,8 +60,10 @@ void init_variant(const Variant* v) {
 /// 'On change' actions, triggered by an option's value change
 void on_clear_hash(const Option&) { Search::clear(); }
 void on_hash_size(const Option& o) { TT.resize(size_t(o)); }
+void on_eval_cache(const Option& o) { Threads.set_eval_cache(size_t(o)); }
 void on_logger(const Option& o) { start_logger(o); }
 void on_threads(const Option& o) { Threads.set(size_t(o)); }
+void on_cpu_cluster(const Option& o) { Threads.cluster = o == "big" ? CpuCluster::BIG : o == "little" ? CpuCluster::LITTLE : CpuCluster::ALL; }
 void on_tb_path(const Option& o) { Tablebases::init(o); }
 
 void on_use_NNUE(const Option& ) { Eval::NNUE::init(); }
@@ -182,8 +184,10 @@ void init(OptionsMap& o) {
 
   o["Debug Log File"]        << Option("", on_logger);
   o["Threads"]               << Option(1, 1, 512, on_threads);
+  o["CPU Cluster"]           << Option("all", {"all", "big", "little"}, on_cpu_cluster);
   o["Hash"]                  << Option(16, 1, MaxHashMB, on_hash_size);
   o["Clear Hash"]            << Option(on_clear_hash);
+  o["Eval Cache"]            << Option(1, 0, 1024, on_eval_cache);
   o["Ponder"]                << Option(false);
   o["MultiPV"]               << Option(1, 1, 500);
   o["Skill Level"]           << Option(20, -20, 20);
@@ -191,10 +195,16 @@ void init(OptionsMap& o) {
   o["Slow Mover"]            << Option(100, 10, 1000);
   o["nodestime"]             << Option(0, 0, 10000);
   o["UCI_Chess960"]          << Option(false);
+#if defined(JANGGI_ONLY) || !defined(PRECOMPUTED_MAGICS)
+  // Only the magics of the Janggi pieces are initialized in these builds
+  o["UCI_Variant"]           << Option("janggi", variants.get_keys(), on_variant_change);
+#else
   o["UCI_Variant"]           << Option("chess", variants.get_keys(), on_variant_change);
+#endif
   o["UCI_AnalyseMode"]       << Option(false);
   o["UCI_LimitStrength"]     << Option(false);
   o["UCI_Elo"]               << Option(1350, 500, 2850);
+  o["Strength By Nodes"]     << Option(false);
   o["UCI_ShowWDL"]           << Option(false);
   o["SyzygyPath"]            << Option("<empty>", on_tb_path);
   o["SyzygyProbeDepth"]      << Option(1, 1, 100);
@@ -16,6 +16,7 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -43,11 +44,13 @@ namespace {
         v->pieceToCharTable = "PNBRQ................Kpnbrq................k";
         return v;
     }
+#ifndef JANGGI_ONLY
     // Standard chess
     // https://en.wikipedia.org/wiki/Chess
     Variant* chess_variant() {
         Variant* v = chess_variant_base()->init();
         v->nnueAlias = "nn-";
+        v->lazyEval = true;
         return v;
     }
     // Chess960 aka Fischer random chess
@@ -1202,6 +1205,7 @@ namespace {
         v->passOnStalemate[BLACK] = true;
         return v;
     }
+#endif // JANGGI_ONLY
     // Minixiangqi
     // http://mlwi.magix.net/bg/minixiangqi.htm
     Variant* minixiangqi_variant() {
@@ -1229,6 +1233,7 @@ namespace {
         return v;
     }
 #ifdef LARGEBOARDS
+#ifndef JANGGI_ONLY
     // Shogi (Japanese chess)
     // https://en.wikipedia.org/wiki/Shogi
     Variant* shogi_variant() {
@@ -1706,6 +1711,7 @@ namespace {
         return v;
     }
 #endif
+#endif // JANGGI_ONLY
     // Xiangqi (Chinese chess)
     // https://en.wikipedia.org/wiki/Xiangqi
     // Xiangqi base variant for inheriting rules without chasing rules
@@ -1726,6 +1732,7 @@ namespace {
         v->soldierPromotionRank = RANK_6;
         return v;
     }
+#ifndef JANGGI_ONLY
     Variant* xiangqi_variant() {
         Variant* v = xiangqi_variant_base()->init();
         v->chasingRule = AXF_CHASING;
@@ -1762,6 +1769,7 @@ namespace {
             make_bitboard(SQ_A6, SQ_A7, SQ_C6, SQ_C7, SQ_E6, SQ_E7, SQ_G6, SQ_G7, SQ_I6, SQ_I7);
         return v;
     }
+#endif // JANGGI_ONLY
     // Janggi (Korean chess)
     // https://en.wikipedia.org/wiki/Janggi
     // Official tournament rules with bikjang and material counting.
@@ -1831,6 +1839,7 @@ namespace {
 
 void VariantMap::init() {
     // Add to UCI_Variant option
+#ifndef JANGGI_ONLY
     add("chess", chess_variant());
     add("normal", chess_variant());
     add("fischerandom", chess960_variant());
@@ -1919,7 +1928,9 @@ void VariantMap::init() {
     add("flipello", flipello_variant());
     add("minixiangqi", minixiangqi_variant());
     add("raazuvaa", raazuvaa_variant());
+#endif
 #ifdef LARGEBOARDS
+#ifndef JANGGI_ONLY
     add("shogi", shogi_variant());
     add("checkshogi", checkshogi_variant());
     add("shoshogi", shoshogi_variant());
@@ -1952,6 +1963,7 @@ void VariantMap::init() {
     add("xiangqi", xiangqi_variant());
     add("manchu", manchu_variant());
     add("supply", supply_variant());
+#endif
     add("janggi", janggi_variant());
     add("janggitraditional", janggi_traditional_variant());
     add("janggimodern", janggi_modern_variant());
@@ -1987,6 +1999,23 @@ Variant* Variant::conclude() {
                   && !cambodianMoves
                   && !diagonalLines;
 
+    // The attack maps of Position know how the pieces of Janggi are blocked,
+    // and that a move only changes the occupancy of its from and to squares
+    attackMaps =   variantTemplate == "janggi"
+                && !(pieceTypes & ~(piece_set(ROOK) | HORSE | JANGGI_ELEPHANT | JANGGI_CANNON | SOLDIER | WAZIR | KING))
+                && !doubleStep && !castling && !pieceDrops && !gating && !seirawanGating
+                && wallingRule == NO_WALLING && !petrifyOnCaptureTypes && !blastOnCapture
+                && flipEnclosedPieces == NO_ENCLOSING;
+
+    // The Janggi variants share an evaluation with the rules of other variants folded out
+    janggiRules =   attackMaps
+                 && !capturesToHand && !checkCounting && !twoBoards && !pieceDrops && !seirawanGating
+                 && !mustCapture && !chess960 && !blastOnCapture && flipEnclosedPieces == NO_ENCLOSING
+                 && !connectN && extinctionValue == VALUE_NONE && !flagRegion[WHITE] && !flagRegion[BLACK]
+                 && !makpongRule && !pieceDemotion && kingType == WAZIR && checking && !lazyEval
+                 && std::all_of(std::begin(promotedPieceType), std::end(promotedPieceType),
+                                [](PieceType pt) { return pt == NO_PIECE_TYPE; });
+
     // Initialize calculated NNUE properties
     nnueKing =  pieceTypes & KING ? KING
               : extinctionPieceCount == 0 && (extinctionPieceTypes & COMMONER) ? COMMONER
@@ -2169,7 +2198,11 @@ void VariantMap::parse_istream(std::istream& file) {
                 std::cerr << "Parsing variant: " << variant << std::endl;
             Variant* v = !variant_template.empty() ? VariantParser<DoCheck>(attribs).parse((new Variant(*variants.find(variant_template)->second))->init())
                                                    : VariantParser<DoCheck>(attribs).parse();
-            if (v->maxFile <= FILE_MAX && v->maxRank <= RANK_MAX)
+            if (   v->maxFile <= FILE_MAX && v->maxRank <= RANK_MAX
+#ifdef JANGGI_ONLY
+                && !(v->pieceTypes & ~JANGGI_PIECES)
+#endif
+               )
             {
                 add(variant, v);
                 // In order to allow inheritance, we need to temporarily add configured variants
@@ -163,9 +163,13 @@ struct Variant {
   CountingRule countingRule = NO_COUNTING;
   CastlingRights castlingWins = NO_CASTLING;
 
+  bool lazyEval = false; // Chess lazy evaluation margins apply (JanggiRules has its own)
+
   // Derived properties
   bool fastAttacks = true;
   bool fastAttacks2 = true;
+  bool attackMaps = false; // Position keeps the attack sets, see Position::piece_attacks()
+  bool janggiRules = false; // Evaluated with JanggiRules, see evaluate.cpp
   std::string nnueAlias = "";
   PieceType nnueKing = KING;
   int nnueDimensions;
@@ -222,6 +226,7 @@ struct Variant {
   Variant* init() {
       nnueAlias = "";
       endgameEval = EG_EVAL_CHESS;
+      lazyEval = false;
       return this;
   }
 
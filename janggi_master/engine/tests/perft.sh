@@ -187,9 +187,6 @@ if [[ $1 == "all" ||  $1 == "largeboard" ]]; then
   expect perft.exp xiangqi "fen 1rbaka2R/5r3/6n2/2p1p1p2/4P1bP1/PpC3Bc1/1nPR2P2/2N2AN2/1c2K1p2/2BAC4 w - - 0 1" 4 4485547 > /dev/null
   expect perft.exp xiangqi "fen 4kcP1N/8n/3rb4/9/9/9/9/3p1A3/4K4/5CB2 w - - 0 1" 4 92741 > /dev/null
   expect perft.exp manchu startpos 4 798554 > /dev/null
-  expect perft.exp janggi startpos 4 1065277 > /dev/null
-  expect perft.exp janggi "fen 1n1kaabn1/cr2N4/5C1c1/p1pNp3p/9/9/P1PbP1P1P/3r1p3/4A4/R1BA1KB1R b - - 0 1" 4 76763 > /dev/null
-  expect perft.exp janggi "fen 1Pbcka3/3nNn1c1/N2CaC3/1pB6/9/9/5P3/9/4K4/9 w - - 0 23" 4 151202 > /dev/null
   expect perft.exp jesonmor startpos 3 27960 > /dev/null
   expect perft.exp jesonmor "fen nn1nnn1nn/9/3n1n3/9/9/9/3N1N3/9/NN1NNN1NN w - - 4 3" 3 37564 > /dev/null
 
@@ -203,6 +200,15 @@ if [[ $1 == "all" ]]; then
   expect perft.exp amazons startpos 1 2176 > /dev/null
 fi
 
+# janggi, also the only section a -DJANGGI_ONLY=ON build supports
+if [[ $1 == "all" || $1 == "largeboard" || $1 == "janggi" ]]; then
+  # startpos is the RBNA1ANBR setup of this tree, the FEN the upstream RNBA1ABNR one
+  expect perft.exp janggi startpos 4 1087883 > /dev/null
+  expect perft.exp janggi "fen rnba1abnr/4k4/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/4K4/RNBA1ABNR w - - 0 1" 4 1065277 > /dev/null
+  expect perft.exp janggi "fen 1n1kaabn1/cr2N4/5C1c1/p1pNp3p/9/9/P1PbP1P1P/3r1p3/4A4/R1BA1KB1R b - - 0 1" 4 76763 > /dev/null
+  expect perft.exp janggi "fen 1Pbcka3/3nNn1c1/N2CaC3/1pB6/9/9/5P3/9/4K4/9 w - - 0 23" 4 151202 > /dev/null
+fi
+
 rm perft.exp
 
 echo "perft testing OK"
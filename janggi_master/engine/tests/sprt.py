@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+# SPRT self-play match between two UCI engines
+# arguments: ./sprt.py ./old_engine ./new_engine [options]
+# examples:
+#   Gainer, 20k nodes per move: ./sprt.py ./old_engine ./new_engine --nodes 20000
+#   Non-regression:             ./sprt.py ./old_engine ./new_engine --elo0 -5 --elo1 0
+#   Own openings:               ./sprt.py ./old_engine ./new_engine --openings fens.txt
+#
+# Openings are fixed positions as for bench, one FEN per line, by default the
+# 16 Janggi setups. Each game pair starts from an opening and the same random
+# plies, with colors reversed. The match stops once the log-likelihood ratio of
+# elo1 against elo0 leaves the bounds given by alpha and beta, or after --games.
+# The exit code is 1 if elo0 is accepted.
+
+import argparse
+import math
+import random
+import subprocess
+import sys
+
+SETUPS = ["rnba1abnr", "rnba1anbr", "rbna1abnr", "rbna1anbr"]
+JANGGI_OPENINGS = ["%s/4k4/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/4K4/%s w - - 0 1" % (b, w.upper())
+                   for b in SETUPS for w in SETUPS]
+
+MATE = 100000
+
+
+class Engine:
+    def __init__(self, path, variant, hash_mb):
+        self.path = path
+        self.process = subprocess.Popen([path], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                        universal_newlines=True, bufsize=1)
+        self.send("uci")
+        self.wait("uciok")
+        self.send("setoption name UCI_Variant value " + variant)
+        self.send("setoption name Hash value %d" % hash_mb)
+        self.send("isready")
+        self.wait("readyok")
+
+    def send(self, command):
+        self.process.stdin.write(command + "\n")
+
+    def wait(self, prefix):
+        lines = []
+        while True:
+            line = self.process.stdout.readline()
+            if not line:
+                sys.exit("%s died" % self.path)
+            lines.append(line.strip())
+            if line.startswith(prefix):
+                return lines
+
+    def position(self, fen, moves):
+        self.send("position fen " + fen + (" moves " + " ".join(moves) if moves else ""))
+
+    def legal_moves(self, fen, moves):
+        self.position(fen, moves)
+        self.send("go perft 1")
+        return [l.split(":")[0] for l in self.wait("Nodes searched") if ": " in l and not l.startswith("Nodes")]
+
+    def new_game(self):
+        self.send("ucinewgame")
+        self.send("isready")
+        self.wait("readyok")
+
+    def go(self, fen, moves, limit):
+        """Returns the best move, or None at the end of the game, and the last
+        score from the side to move."""
+        self.position(fen, moves)
+        self.send("go " + limit)
+        score = None
+        for line in self.wait("bestmove"):
+            tokens = line.split()
+            if tokens and tokens[0] == "info" and "score" in tokens:
+                kind, value = tokens[tokens.index("score") + 1:tokens.index("score") + 3]
+                value = int(value)
+                score = value if kind == "cp" else MATE - value if value > 0 else -MATE - value
+        best = tokens[1]
+        return (None if best == "(none)" else best), score
+
+
+def play_game(engines, fen, opening, limit, max_plies, resign):
+    """Plays a game between engines[0], to move in 'fen', and engines[1].
+    Returns the result for engines[0]."""
+    moves = list(opening)
+    scores = []
+    for engine in engines:
+        engine.new_game()
+    for ply in range(len(moves), max_plies):
+        side = ply % 2
+        best, score = engines[side].go(fen, moves, limit)
+        if best is None:
+            # The game is over for the side to move: mated or a variant result
+            result = 0.5 if not score else 1.0 if score > 0 else 0.0
+            return result if side == 0 else 1 - result
+        moves.append(best)
+        scores.append(None if score is None else score if side == 0 else -score)
+        # Adjudicate when both engines agree for two moves each
+        last = scores[-4:]
+        if len(last) == 4 and None not in last:
+            if min(last) >= resign:
+                return 1.0
+            if max(last) <= -resign:
+                return 0.0
+    return 0.5
+
+
+def llr(wins, draws, losses, elo0, elo1):
+    """Generalized SPRT log-likelihood ratio of elo1 against elo0 for the
+    trinomial game results, using the normal approximation."""
+    n = wins + draws + losses
+    if not n:
+        return 0.0
+    score = (wins + draws / 2) / n
+    var = (wins * (1 - score) ** 2 + draws * (0.5 - score) ** 2 + losses * score ** 2) / n
+    if var <= 0:
+        return 0.0
+    s0, s1 = [1 / (1 + 10 ** (-elo / 400)) for elo in (elo0, elo1)]
+    return (s1 - s0) * (2 * score - s0 - s1) * n / (2 * var)
+
+
+def elo(wins, draws, losses):
+    n = wins + draws + losses
+    score = (wins + draws / 2) / n if n else 0.5
+    if score <= 0 or score >= 1:
+        return math.copysign(math.inf, score - 0.5)
+    return -400 * math.log10(1 / score - 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="SPRT self-play match between two UCI engines")
+    parser.add_argument("old_engine")
+    parser.add_argument("new_engine")
+    parser.add_argument("--variant", default="janggi")
+    parser.add_argument("--openings", help="file with one opening FEN per line")
+    parser.add_argument("--nodes", type=int, default=20000, help="nodes per move")
+    parser.add_argument("--movetime", type=int, help="milliseconds per move, instead of nodes")
+    parser.add_argument("--random-plies", type=int, default=4, help="random plies after each opening")
+    parser.add_argument("--max-plies", type=int, default=300, help="plies before a game is drawn")
+    parser.add_argument("--resign", type=int, default=1500, help="score adjudicated as a win")
+    parser.add_argument("--hash", type=int, default=16)
+    parser.add_argument("--elo0", type=float, default=0)
+    parser.add_argument("--elo1", type=float, default=5)
+    parser.add_argument("--alpha", type=float, default=0.05)
+    parser.add_argument("--beta", type=float, default=0.05)
+    parser.add_argument("--games", type=int, default=20000, help="maximum number of games")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    if args.openings:
+        with open(args.openings) as f:
+            openings = [l.strip() for l in f if l.strip()]
+    else:
+        openings = JANGGI_OPENINGS
+    limit = "movetime %d" % args.movetime if args.movetime else "nodes %d" % args.nodes
+    lower = math.log(args.beta / (1 - args.alpha))
+    upper = math.log((1 - args.beta) / args.alpha)
+
+    old = Engine(args.old_engine, args.variant, args.hash)
+    new = Engine(args.new_engine, args.variant, args.hash)
+    rng = random.Random(args.seed)
+    wins = draws = losses = 0
+    ratio = 0.0
+
+    for pair in range(args.games // 2):
+        fen = openings[pair % len(openings)]
+        opening = []
+        for _ in range(args.random_plies):
+            legal = old.legal_moves(fen, opening)
+            if not legal:
+                break
+            opening.append(rng.choice(legal))
+
+        for engines, sign in (((new, old), 1), ((old, new), -1)):
+            result = play_game(engines, fen, opening, limit, args.max_plies, args.resign)
+            result = result if sign > 0 else 1 - result
+            wins += result == 1
+            draws += result == 0.5
+            losses += result == 0
+            ratio = llr(wins, draws, losses, args.elo0, args.elo1)
+            print("games %d W %d D %d L %d elo %.1f LLR %.2f [%.2f, %.2f]"
+                  % (wins + draws + losses, wins, draws, losses, elo(wins, draws, losses), ratio, lower, upper))
+            sys.stdout.flush()
+
+        if not lower < ratio < upper:
+            break
+
+    for engine in (old, new):
+        engine.send("quit")
+
+    if ratio >= upper:
+        print("H1 accepted: elo >= %g" % args.elo1)
+    elif ratio <= lower:
+        print("H0 accepted: elo <= %g" % args.elo0)
+    else:
+        print("inconclusive")
+    return 1 if ratio <= lower else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
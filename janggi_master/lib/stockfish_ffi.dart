@@ -73,6 +73,7 @@ class StockfishFFI {
   static const int _maxHashMb = 512;
   static const int _maxThreads = 64;
   static String _activeVariant = RuleMode.officialKja.engineVariantName;
+  static int? _strengthElo;
 
   static void _log(String message) {
     _logLifecycle(message);
@@ -264,6 +265,7 @@ class StockfishFFI {
       _stockfishCleanup();
       _initialized = false;
       _activeVariant = RuleMode.officialKja.engineVariantName;
+      _strengthElo = null;
       _log('Stockfish engine cleaned up');
     }
   }
@@ -331,12 +333,22 @@ class StockfishFFI {
   static String? getBestMove({
     int depth = 10,
     int? movetime,
+    int? latency,
+    int? elo,
     bool allowPass = false,
   }) {
-    String cmd = 'go depth $depth';
+    // With an Elo the engine limits its strength by a node budget instead
+    // of a depth cap, so every move of a level costs about the same.
+    _setStrength(elo);
+    String cmd = elo != null ? 'go' : 'go depth $depth';
     if (movetime != null && movetime > 0) {
       cmd += ' movetime $movetime';
     }
+    // Soft deadline: the engine answers within 'latency' ms and stops
+    // earlier when its best move is stable.
+    if (latency != null && latency > 0) {
+      cmd += ' latency $latency';
+    }
 
     _logSearch('StockfishFFI.getBestMove: Sending command: $cmd');
     final response = command(cmd);
@@ -355,6 +367,19 @@ class StockfishFFI {
     return selectedMove;
   }
 
+  static void _setStrength(int? elo) {
+    if (elo == _strengthElo) {
+      return;
+    }
+
+    _strengthElo = elo;
+    command('setoption name UCI_LimitStrength value ${elo != null}');
+    if (elo != null) {
+      command('setoption name Strength By Nodes value true');
+      command('setoption name UCI_Elo value $elo');
+    }
+  }
+
   static bool isUsableUciMove(String move) {
     final normalized = move.trim().toLowerCase();
     if (normalized.isEmpty || normalized == '0000' || normalized == '(none)') {
@@ -560,6 +585,8 @@ class StockfishFFI {
     String variant = 'janggi',
     int depth = 10,
     int? movetime,
+    int? latency,
+    int? elo,
     bool allowPass = true,
     int? threads,
     int? hashMb,
@@ -576,6 +603,8 @@ class StockfishFFI {
             'fen': fen,
             'depth': depth,
             'movetime': movetime,
+            'latency': latency,
+            'elo': elo,
             'allowPass': allowPass,
           },
         ),
@@ -589,6 +618,8 @@ class StockfishFFI {
     String variant = 'janggi',
     int depth = 10,
     int? movetime,
+    int? latency,
+    int? elo,
     int? threads,
     int? hashMb,
   }) {
@@ -605,6 +636,8 @@ class StockfishFFI {
             'moves': moves,
             'depth': depth,
             'movetime': movetime,
+            'latency': latency,
+            'elo': elo,
           },
         ),
       ),
@@ -685,6 +718,8 @@ String? _getBestMoveInIsolate(Map<String, dynamic> request) {
   final fen = request['fen'] as String;
   final depth = request['depth'] as int? ?? 10;
   final movetime = request['movetime'] as int?;
+  final latency = request['latency'] as int?;
+  final elo = request['elo'] as int?;
   final allowPass = request['allowPass'] as bool? ?? true;
 
   return _runWithInitializedEngine<String?>(request, () {
@@ -693,6 +728,8 @@ String? _getBestMoveInIsolate(Map<String, dynamic> request) {
     return StockfishFFI.getBestMove(
       depth: depth,
       movetime: movetime,
+      latency: latency,
+      elo: elo,
       allowPass: allowPass,
     );
   });
@@ -705,6 +742,8 @@ String? _getBestMoveFromHistoryInIsolate(Map<String, dynamic> request) {
       .toList(growable: false);
   final depth = request['depth'] as int? ?? 10;
   final movetime = request['movetime'] as int?;
+  final latency = request['latency'] as int?;
+  final elo = request['elo'] as int?;
 
   return _runWithInitializedEngine<String?>(request, () {
     final variant = _requestVariant(request);
@@ -712,6 +751,8 @@ String? _getBestMoveFromHistoryInIsolate(Map<String, dynamic> request) {
     return StockfishFFI.getBestMove(
       depth: depth,
       movetime: movetime,
+      latency: latency,
+      elo: elo,
       allowPass: true,
     );
   });